@@ -0,0 +1,189 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <syscalls.h>
+#include <time.h>
+#include <window.h>
+
+// microbenchmarks for the kernel and libc hot paths - every line of
+// output is one CSV record, so results can be tracked across releases:
+//   bench,<name>,ops=N,total_ns=N,ns_per_op=N
+//   bench,<name>,bytes=N,total_ns=N,mb_per_s=N
+
+#define SYSCALL_OPS 100000
+#define WRITE_OPS 10000
+#define MALLOC_OPS 10000
+#define IOMSG_OPS 1000
+#define PIPE_CHUNK 65536
+#define PIPE_TOTAL (8 * 1024 * 1024)
+#define FREAD_CHUNK 65536
+
+static uint8_t chunk[PIPE_CHUNK];
+
+static void report(const char* name, uint64_t ops, uint64_t ns) {
+    printf("bench,%s,ops=%llu,total_ns=%llu,ns_per_op=%llu\n", name, ops, ns, ops ? ns / ops : 0);
+}
+
+static void report_bw(const char* name, uint64_t bytes, uint64_t ns) {
+    // 1 MB = 10^6 bytes, so MB/s = bytes * 1000 / ns
+    printf("bench,%s,bytes=%llu,total_ns=%llu,mb_per_s=%llu\n", name, bytes, ns, ns ? bytes * 1000ull / ns : 0);
+}
+
+// cheapest syscall we have - measures pure entry/exit cost
+static void bench_syscall(void) {
+    uint64_t start = uptime_ns();
+    for (int i = 0; i < SYSCALL_OPS; i++) {
+        sys_getpid();
+    }
+    report("syscall_getpid", SYSCALL_OPS, uptime_ns() - start);
+}
+
+// zero-length write exercises fd dispatch without spamming the console
+static void bench_write(void) {
+    uint64_t start = uptime_ns();
+    for (int i = 0; i < WRITE_OPS; i++) {
+        sys_write(FDN_STDOUT, chunk, 0);
+    }
+    report("syscall_write0", WRITE_OPS, uptime_ns() - start);
+}
+
+static void bench_malloc_size(const char* name, size_t size) {
+    uint64_t start = uptime_ns();
+    for (int i = 0; i < MALLOC_OPS; i++) {
+        void* p = malloc(size);
+        if (p == NULL) {
+            printf("bench: %s: malloc failed\n", name);
+            return;
+        }
+        free(p);
+    }
+    report(name, MALLOC_OPS, uptime_ns() - start);
+}
+
+// mixed sizes with many live allocations, closer to real app behavior
+static void bench_malloc_mixed(void) {
+    static void* ptrs[256];
+    static const size_t sizes[4] = {16, 64, 256, 4096};
+
+    uint64_t start = uptime_ns();
+    for (int round = 0; round < MALLOC_OPS / 256; round++) {
+        for (int i = 0; i < 256; i++) {
+            ptrs[i] = malloc(sizes[i % 4]);
+        }
+        for (int i = 0; i < 256; i++) {
+            free(ptrs[i]);
+        }
+    }
+    report("malloc_mixed", (uint64_t)(MALLOC_OPS / 256) * 512, uptime_ns() - start);
+}
+
+// round-trip time of the window IPC path: one flush_component_image
+// per iteration against a small image component
+static void bench_iomsg(void) {
+    static uint32_t framebuf[32 * 32];
+
+    component_descriptor* wdesc = create_component_window("bench", 0, 0, 100, 100);
+    if (wdesc == NULL) {
+        printf("bench: iomsg: no window manager, skipped\n");
+        return;
+    }
+
+    component_descriptor* idesc = create_component_image(wdesc, 32, 32, PIXEL_FORMAT_BGRA, framebuf);
+    if (idesc == NULL) {
+        printf("bench: iomsg: failed to create image\n");
+        remove_component(wdesc);
+        return;
+    }
+
+    uint64_t start = uptime_ns();
+    for (int i = 0; i < IOMSG_OPS; i++) {
+        flush_component_image(idesc, 0, 0, 32, 32);
+    }
+    report("iomsg_flush", IOMSG_OPS, uptime_ns() - start);
+
+    remove_component(idesc);
+    remove_component(wdesc);
+}
+
+// parent writes PIPE_TOTAL bytes into a pipe drained by an exec'd child
+static void bench_pipe(const char* self) {
+    char args[128];
+    if (snprintf(args, sizeof(args), "%s pipe-sink", self) >= (int)sizeof(args)) {
+        printf("bench: pipe: path too long\n");
+        return;
+    }
+
+    int pipefd[2];
+    if (sys_pipe(pipefd) == -1) {
+        printf("bench: pipe: sys_pipe failed\n");
+        return;
+    }
+
+    pid_t pid = sys_exec(args, EXEC_FLAG_NONE, (int[]){pipefd[0], -1, -1});
+    if (pid == -1) {
+        printf("bench: pipe: exec failed\n");
+        return;
+    }
+
+    uint64_t start = uptime_ns();
+    for (size_t sent = 0; sent < PIPE_TOTAL; sent += sizeof(chunk)) {
+        if (sys_write(pipefd[1], chunk, sizeof(chunk)) == -1) {
+            printf("bench: pipe: write failed\n");
+            return;
+        }
+    }
+    sys_close(pipefd[1]);
+    sys_wait(pid, WAIT_FLAG_NONE);
+    report_bw("pipe_bw", PIPE_TOTAL, uptime_ns() - start);
+
+    sys_close(pipefd[0]);
+}
+
+static int pipe_sink(void) {
+    int n;
+    while ((n = sys_read(FDN_STDIN, chunk, sizeof(chunk))) > 0)
+        ;
+    return n == 0 ? 0 : -1;
+}
+
+// sequential fread of a whole file through the stdio layer
+static void bench_fread(const char* path) {
+    FILE* file = fopen(path, "r");
+    if (file == NULL) {
+        printf("bench: fread: failed to open %s\n", path);
+        return;
+    }
+
+    uint64_t total = 0;
+    size_t n;
+    uint64_t start = uptime_ns();
+    while ((n = fread(chunk, 1, FREAD_CHUNK, file)) > 0) {
+        total += n;
+    }
+    report_bw("fread_seq", total, uptime_ns() - start);
+
+    fclose(file);
+}
+
+int main(int argc, char const* argv[]) {
+    if (argc > 1 && strcmp(argv[1], "pipe-sink") == 0) {
+        return pipe_sink();
+    }
+
+    if (argc > 2 && strcmp(argv[1], "fread") == 0) {
+        bench_fread(argv[2]);
+        return 0;
+    }
+
+    bench_syscall();
+    bench_write();
+    bench_malloc_size("malloc_16", 16);
+    bench_malloc_size("malloc_256", 256);
+    bench_malloc_size("malloc_4096", 4096);
+    bench_malloc_mixed();
+    bench_iomsg();
+    bench_pipe(argv[0]);
+
+    printf("bench: run \"bench fread <path>\" for file throughput\n");
+    return 0;
+}
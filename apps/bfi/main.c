@@ -1,112 +1,131 @@
 #include <stdint.h>
 #include <stdio.h>
 #include <string.h>
+#include <syscalls.h>
 
 #define MEM_LEN 30000
 #define STACK_LEN 32
+#define CODE_MAX 8192
+#define OUT_BUF_LEN 1024
 
 static uint8_t mem[MEM_LEN] = {0};
 static int stack[STACK_LEN] = {0};
 
-int exec_bf(const char* bf_code) {
+// compiled opcodes - runs of +/-/>/< are folded into one instruction
+// with a count, and loop brackets carry precomputed jump targets so
+// execution never rescans the source
+enum {
+    OP_ADD,
+    OP_SUB,
+    OP_RIGHT,
+    OP_LEFT,
+    OP_OUT,
+    OP_JZ,   // '[': jump past the matching ']' when the cell is 0
+    OP_JNZ,  // ']': jump after the matching '[' when the cell is not 0
+    OP_END,
+};
+
+typedef struct {
+    uint8_t op;
+    int32_t arg;
+} bf_insn;
+
+static bf_insn code[CODE_MAX];
+
+static char out_buf[OUT_BUF_LEN];
+static int out_len = 0;
+
+static void out_flush(void) {
+    if (out_len > 0) {
+        sys_write(FDN_STDOUT, out_buf, out_len);
+        out_len = 0;
+    }
+}
+
+static void out_putc(char c) {
+    out_buf[out_len++] = c;
+    if (out_len == OUT_BUF_LEN) {
+        out_flush();
+    }
+}
+
+// counts a run of the same character starting at ip
+static int run_len(const char* bf_code, int code_len, int ip) {
+    char c = bf_code[ip];
+    int n = 0;
+    while (ip + n < code_len && bf_code[ip + n] == c) {
+        n++;
+    }
+    return n;
+}
+
+static int emit(int* cp, uint8_t op, int32_t arg) {
+    if (*cp >= CODE_MAX) {
+        printf("[ERR]Code too long\n");
+        return -1;
+    }
+
+    code[*cp].op = op;
+    code[*cp].arg = arg;
+    (*cp)++;
+    return 0;
+}
+
+static int compile_bf(const char* bf_code) {
     int code_len = strlen(bf_code);
-    char str[2];
-    // instruction pointer
     int ip = 0;
-    // memory pointer
-    int mp = 0;
-    // stack pointer
+    int cp = 0;
     int sp = 0;
 
-    while (1) {
-        if (code_len <= ip) {
-            break;
-        }
+    while (ip < code_len) {
+        int n;
 
         switch (bf_code[ip]) {
-            // increment pointed value
             case '+':
-                if (mem[mp] == UINT8_MAX) {
-                    printf("[ERR]Memory overflow\n");
-                    return -1;
-                }
-                mem[mp]++;
-                break;
-
-            // decrement pointed value
             case '-':
-                if (mem[mp] == 0) {
-                    printf("[ERR]Memory underflow\n");
-                    return -1;
-                }
-                mem[mp]--;
-                break;
-
-            // output pointed value to ascii
-            case '.':
-                str[0] = (char)mem[mp];
-                str[1] = '\0';
-                printf("%s", str);
-                break;
-
-            // increment pointer
             case '>':
-                // printf(">");
-                if (mp == MEM_LEN - 1) {
-                    printf("[ERR]Memory pointer overflow\n");
+            case '<':
+                n = run_len(bf_code, code_len, ip);
+                uint8_t op = bf_code[ip] == '+'   ? OP_ADD
+                             : bf_code[ip] == '-' ? OP_SUB
+                             : bf_code[ip] == '>' ? OP_RIGHT
+                                                  : OP_LEFT;
+                if (emit(&cp, op, n) == -1) {
                     return -1;
                 }
-                mp++;
-                break;
+                ip += n;
+                continue;
 
-            // decrement pointer
-            case '<':
-                if (mp == 0) {
-                    printf("[ERR]Memory pointer underflow\n");
+            case '.':
+                if (emit(&cp, OP_OUT, 0) == -1) {
                     return -1;
                 }
-                mp--;
                 break;
 
-            // start loop
             case '[':
-                stack[sp++] = ip;
                 if (sp >= STACK_LEN) {
                     printf("[ERR]Stack overflow\n");
                     return -1;
                 }
-
-                if (mem[mp] == 0) {
-                    while (1) {
-                        ip++;
-                        if (ip >= code_len) {
-                            printf("[ERR]Unmatched '['\n");
-                            return -1;
-                        }
-                        if (bf_code[ip] == ']') {
-                            sp--;
-                            break;
-                        } else if (bf_code[ip] == '[') {
-                            sp++;
-                            break;
-                        }
-                    }
+                stack[sp++] = cp;
+                // target patched when the matching ']' is reached
+                if (emit(&cp, OP_JZ, 0) == -1) {
+                    return -1;
                 }
                 break;
 
-            // end loop
-            case ']':
+            case ']': {
                 if (sp == 0) {
                     printf("[ERR]Unmatched ']'\n");
                     return -1;
                 }
-
-                if (mem[mp] != 0) {
-                    ip = stack[sp - 1];
-                } else {
-                    sp--;
+                int open = stack[--sp];
+                if (emit(&cp, OP_JNZ, open + 1) == -1) {
+                    return -1;
                 }
+                code[open].arg = cp;
                 break;
+            }
 
             // skip
             case ' ':
@@ -124,10 +143,96 @@ int exec_bf(const char* bf_code) {
         ip++;
     }
 
-    printf("\n");
+    if (sp != 0) {
+        printf("[ERR]Unmatched '['\n");
+        return -1;
+    }
+
+    if (emit(&cp, OP_END, 0) == -1) {
+        return -1;
+    }
+
     return 0;
 }
 
+int exec_bf(const char* bf_code) {
+    if (compile_bf(bf_code) == -1) {
+        return -1;
+    }
+
+    // instruction pointer
+    int ip = 0;
+    // memory pointer
+    int mp = 0;
+
+    while (1) {
+        bf_insn insn = code[ip];
+
+        switch (insn.op) {
+            case OP_ADD:
+                if (insn.arg > UINT8_MAX - mem[mp]) {
+                    out_flush();
+                    printf("[ERR]Memory overflow\n");
+                    return -1;
+                }
+                mem[mp] += insn.arg;
+                break;
+
+            case OP_SUB:
+                if (insn.arg > mem[mp]) {
+                    out_flush();
+                    printf("[ERR]Memory underflow\n");
+                    return -1;
+                }
+                mem[mp] -= insn.arg;
+                break;
+
+            case OP_RIGHT:
+                if (insn.arg > MEM_LEN - 1 - mp) {
+                    out_flush();
+                    printf("[ERR]Memory pointer overflow\n");
+                    return -1;
+                }
+                mp += insn.arg;
+                break;
+
+            case OP_LEFT:
+                if (insn.arg > mp) {
+                    out_flush();
+                    printf("[ERR]Memory pointer underflow\n");
+                    return -1;
+                }
+                mp -= insn.arg;
+                break;
+
+            case OP_OUT:
+                out_putc((char)mem[mp]);
+                break;
+
+            case OP_JZ:
+                if (mem[mp] == 0) {
+                    ip = insn.arg;
+                    continue;
+                }
+                break;
+
+            case OP_JNZ:
+                if (mem[mp] != 0) {
+                    ip = insn.arg;
+                    continue;
+                }
+                break;
+
+            case OP_END:
+                out_putc('\n');
+                out_flush();
+                return 0;
+        }
+
+        ip++;
+    }
+}
+
 int main(int argc, char const* argv[]) {
     const char* bf_code = "++ ++ ++ ++[ > ++ ++[ > ++ > ++ + > ++ + > + < < < < -] > + > + >->> +[ < ] < -] >>.> -- -.++ ++ ++ +..++ +.>>.<-.<.++ +.-- -- --.-- -- -- --.>> +.>++.";
 
@@ -1,34 +1,87 @@
 #include <string.h>
 #include <syscalls.h>
 
+// sliding input buffer: large reads refill the back half while partial
+// lines are carried to the front across chunk boundaries
+#define READ_CHUNK 8192
+
+static char buf[READ_CHUNK * 2];
+static char outbuf[READ_CHUNK];
+static size_t out_used = 0;
+
+static void out_flush(void) {
+    if (out_used > 0) {
+        sys_write(1, outbuf, out_used);
+        out_used = 0;
+    }
+}
+
+// batches matched lines so a whole buffer of matches costs one write
+static void out_line(const char* line, size_t len) {
+    if (len + 1 > sizeof(outbuf)) {
+        out_flush();
+        sys_write(1, line, len);
+        sys_write(1, "\n", 1);
+        return;
+    }
+
+    if (out_used + len + 1 > sizeof(outbuf)) {
+        out_flush();
+    }
+
+    memcpy(outbuf + out_used, line, len);
+    out_used += len;
+    outbuf[out_used++] = '\n';
+}
+
 int main(int argc, char* argv[]) {
     if (argc < 2) return 1;
     const char* pattern = argv[1];
 
-    char buf[1024];
-    int n;
+    // bytes of a partial line carried from the previous chunk
+    size_t pending = 0;
 
-    do {
-        n = sys_read(0, buf, sizeof(buf) - 1);
-    } while (n == 0);
+    while (1) {
+        int n = sys_read(0, buf + pending, sizeof(buf) - pending - 1);
+        if (n < 0) {
+            out_flush();
+            return 1;
+        }
+        if (n == 0) break; // EOF: all write ends closed
 
-    if (n < 0) return 1;
-    buf[n] = '\0';
+        size_t avail = pending + (size_t)n;
+        buf[avail] = '\0';
 
-    char* line = buf;
-    char* end;
-    while ((end = strchr(line, '\n')) != NULL) {
-        *end = '\0';
-        if (strstr(line, pattern)) {
-            sys_write(1, line, strlen(line));
-            sys_write(1, "\n", 1);
+        char* line = buf;
+        char* end;
+        while ((end = strchr(line, '\n')) != NULL) {
+            *end = '\0';
+            if (strstr(line, pattern)) {
+                out_line(line, end - line);
+            }
+            line = end + 1;
+        }
+
+        pending = avail - (line - buf);
+        if (pending >= sizeof(buf) - 1) {
+            // line longer than the whole buffer - match what we have and
+            // drop it rather than growing without bound
+            if (strstr(line, pattern)) {
+                out_line(line, pending);
+            }
+            pending = 0;
+        } else if (pending > 0) {
+            memmove(buf, line, pending);
         }
-        line = end + 1;
     }
-    if (*line && strstr(line, pattern)) {
-        sys_write(1, line, strlen(line));
-        sys_write(1, "\n", 1);
+
+    if (pending > 0) {
+        buf[pending] = '\0';
+        if (strstr(buf, pattern)) {
+            out_line(buf, pending);
+        }
     }
 
+    out_flush();
     return 0;
 }
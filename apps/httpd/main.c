@@ -0,0 +1,230 @@
+#include <errno.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/poll.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <syscalls.h>
+#include <time.h>
+
+// poll-driven static file server over the initramfs, used as the
+// standard load generator target for measuring TCP connection setup
+// cost and concurrent-socket scaling. prints one CSV record per
+// STATS_INTERVAL requests:
+//   httpd,served=N,req_per_s=N
+
+#define HTTPD_PORT 8080
+#define MAX_CONNS 16
+#define REQ_BUF_LEN 2048
+#define FILE_CHUNK_LEN 8192
+#define DOC_ROOT "/mnt/initramfs"
+#define STATS_INTERVAL 100
+
+static char req_buf[REQ_BUF_LEN];
+static char file_buf[FILE_CHUNK_LEN];
+static char head_buf[256];
+static char path_buf[512];
+
+static uint64_t served = 0;
+static uint64_t stats_start_ns = 0;
+
+static void send_all(int fd, const void* buf, size_t len) {
+    const char* p = (const char*)buf;
+    while (len > 0) {
+        int n = sys_send(fd, p, len, 0);
+        if (n <= 0)
+            return;
+        p += n;
+        len -= (size_t)n;
+    }
+}
+
+static void send_status(int fd, const char* status) {
+    int n = snprintf(head_buf, sizeof(head_buf),
+                     "HTTP/1.0 %s\r\nContent-Length: 0\r\nConnection: close\r\n\r\n", status);
+    send_all(fd, head_buf, (size_t)n);
+}
+
+static void serve_file(int conn_fd, const char* path) {
+    if (strcmp(path, "/") == 0)
+        path = "/index.html";
+
+    // keep requests inside the document root
+    if (strstr(path, "..") != NULL) {
+        send_status(conn_fd, "403 Forbidden");
+        return;
+    }
+
+    snprintf(path_buf, sizeof(path_buf), "%s%s", DOC_ROOT, path);
+
+    int fd = sys_open(path_buf, OPEN_FLAG_NONE);
+    if (fd == -1) {
+        send_status(conn_fd, "404 Not Found");
+        return;
+    }
+
+    f_stat stat;
+    if (sys_stat(fd, &stat) == -1) {
+        sys_close(fd);
+        send_status(conn_fd, "500 Internal Server Error");
+        return;
+    }
+
+    int head_len = snprintf(head_buf, sizeof(head_buf),
+                            "HTTP/1.0 200 OK\r\nContent-Length: %d\r\nConnection: close\r\n\r\n",
+                            (int)stat.size);
+
+    if (stat.size <= sizeof(file_buf)) {
+        // small file: gather header and body into one send
+        int body_len = sys_read(fd, file_buf, sizeof(file_buf));
+        if (body_len < 0)
+            body_len = 0;
+
+        iovec iov[2];
+        iov[0].iov_base = head_buf;
+        iov[0].iov_len = (size_t)head_len;
+        iov[1].iov_base = file_buf;
+        iov[1].iov_len = (size_t)body_len;
+
+        struct msghdr msg;
+        memset(&msg, 0, sizeof(msg));
+        msg.msg_iov = iov;
+        msg.msg_iovlen = 2;
+        sys_sendmsg(conn_fd, &msg, 0);
+    } else {
+        send_all(conn_fd, head_buf, (size_t)head_len);
+        for (;;) {
+            int n = sys_read(fd, file_buf, sizeof(file_buf));
+            if (n <= 0)
+                break;
+            send_all(conn_fd, file_buf, (size_t)n);
+        }
+    }
+
+    sys_close(fd);
+}
+
+static void handle_request(int conn_fd) {
+    int n = sys_recv(conn_fd, req_buf, sizeof(req_buf) - 1, 0);
+    if (n <= 0)
+        return;
+    req_buf[n] = '\0';
+
+    if (strncmp(req_buf, "GET ", 4) != 0) {
+        send_status(conn_fd, "405 Method Not Allowed");
+        return;
+    }
+
+    char* path = req_buf + 4;
+    char* end = strchr(path, ' ');
+    if (end == NULL) {
+        send_status(conn_fd, "400 Bad Request");
+        return;
+    }
+    *end = '\0';
+
+    serve_file(conn_fd, path);
+}
+
+static void count_request(void) {
+    served++;
+    if (served % STATS_INTERVAL != 0)
+        return;
+
+    uint64_t now_ns = uptime_ns();
+    uint64_t elapsed_ns = now_ns - stats_start_ns;
+    if (elapsed_ns == 0)
+        elapsed_ns = 1;
+
+    printf("httpd,served=%llu,req_per_s=%llu\n", served,
+           (uint64_t)STATS_INTERVAL * 1000000000 / elapsed_ns);
+    stats_start_ns = now_ns;
+}
+
+int main(void) {
+    int listen_fd =
+        sys_socket(SOCKET_DOMAIN_AF_INET, SOCKET_TYPE_SOCK_STREAM | SOCKET_TYPE_NONBLOCK, 0);
+    if (listen_fd < 0) {
+        printf("httpd: failed to create socket\n");
+        return -1;
+    }
+
+    struct sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = SOCKET_DOMAIN_AF_INET;
+    addr.sin_port = HTTPD_PORT;
+    addr.sin_addr.s_addr = 0; // INADDR_ANY
+
+    if (sys_bind(listen_fd, (struct sockaddr*)&addr, sizeof(addr)) < 0) {
+        printf("httpd: failed to bind port %d\n", HTTPD_PORT);
+        return -1;
+    }
+
+    if (sys_listen(listen_fd, MAX_CONNS) < 0) {
+        printf("httpd: failed to listen\n");
+        return -1;
+    }
+
+    printf("httpd: serving %s on port %d\n", DOC_ROOT, HTTPD_PORT);
+
+    pollfd fds[1 + MAX_CONNS];
+    fds[0].fd = listen_fd;
+    fds[0].events = POLLIN;
+    for (int i = 1; i < 1 + MAX_CONNS; i++) {
+        fds[i].fd = -1;
+        fds[i].events = POLLIN;
+    }
+
+    stats_start_ns = uptime_ns();
+
+    for (;;) {
+        int ready = sys_poll(fds, 1 + MAX_CONNS, 1000);
+        if (ready < 0) {
+            printf("httpd: poll failed\n");
+            return -1;
+        }
+        if (ready == 0)
+            continue;
+
+        if (fds[0].revents & POLLIN) {
+            // drain the accept queue; the listener is non-blocking
+            for (;;) {
+                struct sockaddr_in client_addr;
+                memset(&client_addr, 0, sizeof(client_addr));
+                size_t client_addr_len = sizeof(client_addr);
+                int conn_fd =
+                    sys_accept(listen_fd, (struct sockaddr*)&client_addr, &client_addr_len);
+                if (conn_fd < 0)
+                    break;
+
+                int slot = -1;
+                for (int i = 1; i < 1 + MAX_CONNS; i++) {
+                    if (fds[i].fd == -1) {
+                        slot = i;
+                        break;
+                    }
+                }
+
+                if (slot == -1) {
+                    // connection table full
+                    sys_close(conn_fd);
+                    continue;
+                }
+                fds[slot].fd = conn_fd;
+            }
+        }
+
+        for (int i = 1; i < 1 + MAX_CONNS; i++) {
+            if (fds[i].fd == -1 || !(fds[i].revents & POLLIN))
+                continue;
+
+            handle_request(fds[i].fd);
+            sys_close(fds[i].fd);
+            fds[i].fd = -1;
+            count_request();
+        }
+    }
+
+    return 0;
+}
@@ -1,7 +1,45 @@
 #include "errno.h"
+#include "syscalls.h"
 
-int errno;
+#define ERRNO_SLOTS 16
+
+// one errno slot per thread, keyed by pid (user pids start at 1, so
+// pid 0 marks a free slot); threads past the table share the fallback
+typedef struct {
+    pid_t pid;
+    int value;
+} errno_slot;
+
+static errno_slot slots[ERRNO_SLOTS];
+static int errno_fallback;
 
 int* __errno_location(void) {
-    return &errno;
+    pid_t pid = sys_getpid();
+
+    for (int i = 0; i < ERRNO_SLOTS; i++) {
+        if (slots[i].pid == pid)
+            return &slots[i].value;
+    }
+
+    // claim a free slot with a CAS so two threads can never own the
+    // same one; a loser just moves on to the next free slot
+    for (int i = 0; i < ERRNO_SLOTS; i++) {
+        if (slots[i].pid == 0 && __sync_bool_compare_and_swap(&slots[i].pid, 0, pid)) {
+            slots[i].value = 0;
+            return &slots[i].value;
+        }
+    }
+
+    return &errno_fallback;
+}
+
+// frees the calling thread's slot for reuse; called from the pthread
+// exit path so a process that churns threads never exhausts the table
+void __errno_release(void) {
+    pid_t pid = sys_getpid();
+
+    for (int i = 0; i < ERRNO_SLOTS; i++) {
+        if (__sync_bool_compare_and_swap(&slots[i].pid, pid, 0))
+            return;
+    }
 }
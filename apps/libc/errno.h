@@ -1,7 +1,12 @@
 #ifndef _ERRNO_H
 #define _ERRNO_H
 
-extern int errno;
+// each thread is its own task with its own pid, so errno resolves to a
+// per-thread slot instead of one global
+int* __errno_location(void);
+// internal: releases the calling thread's errno slot on thread exit
+void __errno_release(void);
+#define errno (*__errno_location())
 
 #define ENOENT 2
 #define ESRCH 3
@@ -0,0 +1,64 @@
+#include "iomsg.h"
+
+#include "syscalls.h"
+
+void iomsg_batch_begin(iomsg_batch_builder* b, void* buf, size_t buf_len) {
+    b->buf = buf;
+    b->buf_len = buf_len;
+    b->used = sizeof(iomsg_batch);
+
+    iomsg_batch* batch = (iomsg_batch*)buf;
+    batch->header.cmd_id = IOMSG_CMD_BATCH;
+    batch->header.payload_size = b->used - sizeof(iomsg_header);
+    batch->count = 0;
+}
+
+// reserves a sub-message in the batch and returns it with the header
+// filled in, ready for the caller to write the payload - NULL when the
+// buffer is full
+void* iomsg_batch_add(iomsg_batch_builder* b, uint32_t cmd_id, uint32_t payload_size) {
+    size_t msg_len = IOMSG_ALIGN(sizeof(iomsg_header) + payload_size);
+    if (b->used + msg_len > b->buf_len) {
+        return NULL;
+    }
+
+    iomsg_header* header = (iomsg_header*)((char*)b->buf + b->used);
+    header->cmd_id = cmd_id;
+    header->payload_size = payload_size;
+    b->used += msg_len;
+
+    iomsg_batch* batch = (iomsg_batch*)b->buf;
+    batch->count++;
+    batch->header.payload_size = b->used - sizeof(iomsg_header);
+
+    return header;
+}
+
+int iomsg_batch_submit(iomsg_batch_builder* b, void* replybuf, size_t replybuf_len) {
+    return sys_iomsg(b->buf, replybuf, replybuf_len);
+}
+
+// walks the packed replies of a submitted batch, NULL on a bad index or
+// a truncated reply buffer
+const iomsg_header* iomsg_batch_reply(const void* replybuf, size_t replybuf_len, uint32_t index) {
+    const iomsg_batch* batch = (const iomsg_batch*)replybuf;
+    if (batch->header.cmd_id != IOMSG_CMD_BATCH || index >= batch->count) {
+        return NULL;
+    }
+
+    size_t offset = sizeof(iomsg_batch);
+    for (uint32_t i = 0; i < index; i++) {
+        if (offset + sizeof(iomsg_header) > replybuf_len) {
+            return NULL;
+        }
+
+        const iomsg_header* header = (const iomsg_header*)((const char*)replybuf + offset);
+        offset += IOMSG_ALIGN(sizeof(iomsg_header) + header->payload_size);
+    }
+
+    if (offset + sizeof(iomsg_header) > replybuf_len) {
+        return NULL;
+    }
+
+    return (const iomsg_header*)((const char*)replybuf + offset);
+}
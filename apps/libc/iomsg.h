@@ -7,6 +7,13 @@
 #define IOMSG_CMD_REMOVE_COMPONENT 0x80000000
 #define IOMSG_CMD_CREATE_COMPONENT_WINDOW 0x80000001
 #define IOMSG_CMD_CREATE_COMPONENT_IMAGE 0x80000002
+#define IOMSG_CMD_FLUSH_COMPONENT_IMAGE 0x80000003
+#define IOMSG_CMD_BATCH 0x80000004
+#define IOMSG_CMD_SUBSCRIBE_INPUT 0x80000005
+#define IOMSG_CMD_FLIP_COMPONENT_IMAGE 0x80000006
+
+// sub-messages in a batch are packed back to back, each aligned to 8 bytes
+#define IOMSG_ALIGN(len) (((len) + 7) & ~(size_t)7)
 
 typedef struct {
     uint32_t cmd_id;
@@ -46,4 +53,51 @@ typedef struct {
     const void* framebuf;
 } __attribute__((aligned(8))) iomsg_create_component_image;
 
+typedef struct {
+    iomsg_header header;
+    int layer_id;
+    char _reserved0[4];
+    size_t x;
+    size_t y;
+    size_t width;
+    size_t height;
+} __attribute__((aligned(8))) iomsg_flush_component_image;
+typedef _iomsg_with_header_only iomsg_reply_flush_component_image;
+
+// points the compositor at the buffer the client just finished rendering;
+// the retired buffer becomes the client's next render target
+typedef struct {
+    iomsg_header header;
+    int layer_id;
+    char _reserved0[4];
+    const void* framebuf;
+} __attribute__((aligned(8))) iomsg_flip_component_image;
+typedef _iomsg_with_header_only iomsg_reply_flip_component_image;
+
+typedef _iomsg_with_layer_id iomsg_subscribe_input;
+typedef struct {
+    iomsg_header header;
+    int event_fd;
+} __attribute__((aligned(8))) iomsg_reply_subscribe_input;
+
+// batch container: `count` sub-messages follow the container, and the
+// reply buffer is filled with the same layout (container + packed replies)
+typedef struct {
+    iomsg_header header;
+    uint32_t count;
+    char _reserved0[4];
+} __attribute__((aligned(8))) iomsg_batch;
+
+// builds a batch request into a caller-provided buffer
+typedef struct {
+    void* buf;
+    size_t buf_len;
+    size_t used;
+} iomsg_batch_builder;
+
+void iomsg_batch_begin(iomsg_batch_builder* b, void* buf, size_t buf_len);
+void* iomsg_batch_add(iomsg_batch_builder* b, uint32_t cmd_id, uint32_t payload_size);
+int iomsg_batch_submit(iomsg_batch_builder* b, void* replybuf, size_t replybuf_len);
+const iomsg_header* iomsg_batch_reply(const void* replybuf, size_t replybuf_len, uint32_t index);
+
 #endif
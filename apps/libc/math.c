@@ -1,35 +1,399 @@
 #include "math.h"
 
-#include "stdlib.h"
+#include <stdint.h>
 
-// x * 2^exp
-long ldexp(long x, int exp) {
-    if (exp == 0) return x;
-    if (exp > 0) return x << exp;
-    return x >> (-exp);
+// Double-precision math built for -msoft-float: every fp operation is a
+// library call, so the kernels below favor bit manipulation and short
+// table-plus-polynomial evaluations over long iterative schemes.
+
+typedef union {
+    double d;
+    uint64_t u;
+} dbl_bits;
+
+#define DBL_EXP_MASK 0x7ff0000000000000ull
+#define DBL_MANT_MASK 0x000fffffffffffffull
+#define DBL_IMPLICIT_BIT 0x0010000000000000ull
+
+static double make_nan(void) {
+    dbl_bits b = {.u = 0x7ff8000000000000ull};
+    return b.d;
+}
+
+double fabs(double x) {
+    dbl_bits b = {.d = x};
+    b.u &= ~(1ull << 63);
+    return b.d;
 }
 
-// x^y
-long pow(long base, long exp) {
-    long res = 1;
-    while (exp > 0) {
-        if (exp % 2 == 1) res *= base;
-        base *= base;
-        exp /= 2;
+double floor(double x) {
+    dbl_bits b = {.d = x};
+    int e = (int)((b.u >> 52) & 0x7ff) - 1023;
+
+    // already integral, inf or NaN
+    if (e >= 52)
+        return x;
+
+    // |x| < 1
+    if (e < 0) {
+        if (x == 0.0)
+            return x;
+        return (b.u >> 63) ? -1.0 : 0.0;
     }
-    return res;
+
+    uint64_t frac_mask = DBL_MANT_MASK >> e;
+    if ((b.u & frac_mask) == 0)
+        return x;
+
+    b.u &= ~frac_mask;
+    return (b.u >> 63) ? b.d - 1.0 : b.d;
 }
 
-long floor(long x) {
-    return x;  // Integer identity
+double ceil(double x) {
+    dbl_bits b = {.d = x};
+    int e = (int)((b.u >> 52) & 0x7ff) - 1023;
+
+    if (e >= 52)
+        return x;
+
+    if (e < 0) {
+        if (x == 0.0)
+            return x;
+        return (b.u >> 63) ? -0.0 : 1.0;
+    }
+
+    uint64_t frac_mask = DBL_MANT_MASK >> e;
+    if ((b.u & frac_mask) == 0)
+        return x;
+
+    b.u &= ~frac_mask;
+    return (b.u >> 63) ? b.d : b.d + 1.0;
 }
 
-long frexp(long x, int* exp) {
-    *exp = 0;
-    return x;
+// exact remainder by aligning the raw mantissas (long-division style),
+// so large x / small y does not lose precision the way
+// x - floor(x / y) * y would
+double fmod(double x, double y) {
+    dbl_bits ux = {.d = x};
+    dbl_bits uy = {.d = y};
+    int ex = (int)((ux.u >> 52) & 0x7ff);
+    int ey = (int)((uy.u >> 52) & 0x7ff);
+    uint64_t sign = ux.u & (1ull << 63);
+    uint64_t mx = ux.u;
+    uint64_t my = uy.u;
+
+    if (y == 0.0 || ex == 0x7ff || (uy.u << 1) > (0xffeull << 53))
+        return make_nan();
+    if ((mx << 1) <= (my << 1))
+        return (mx << 1) == (my << 1) ? 0.0 * x : x;
+
+    // normalize both mantissas to 53 bits with the implicit bit set
+    if (ex == 0) {
+        for (uint64_t i = mx << 12; (i >> 63) == 0; ex--, i <<= 1);
+        mx <<= -ex + 1;
+    } else {
+        mx = (mx & DBL_MANT_MASK) | DBL_IMPLICIT_BIT;
+    }
+    if (ey == 0) {
+        for (uint64_t i = my << 12; (i >> 63) == 0; ey--, i <<= 1);
+        my <<= -ey + 1;
+    } else {
+        my = (my & DBL_MANT_MASK) | DBL_IMPLICIT_BIT;
+    }
+
+    for (; ex > ey; ex--) {
+        uint64_t i = mx - my;
+        if ((i >> 63) == 0) {
+            if (i == 0)
+                return 0.0 * x;
+            mx = i;
+        }
+        mx <<= 1;
+    }
+    uint64_t i = mx - my;
+    if ((i >> 63) == 0) {
+        if (i == 0)
+            return 0.0 * x;
+        mx = i;
+    }
+    for (; (mx >> 52) == 0; mx <<= 1, ex--);
+
+    // rebuild the result (denormal when the exponent underflows)
+    if (ex > 0) {
+        mx -= DBL_IMPLICIT_BIT;
+        mx |= (uint64_t)ex << 52;
+    } else {
+        mx >>= -ex + 1;
+    }
+    ux.u = mx | sign;
+    return ux.d;
 }
 
-long fmod(long x, long y) {
-    if (y == 0) return 0;
-    return x % y;
+// digit-by-digit square root on the raw mantissa: one result bit per
+// step, no fp divisions at all
+double sqrt(double x) {
+    dbl_bits b = {.d = x};
+    int e = (int)((b.u >> 52) & 0x7ff);
+
+    if (x == 0.0 || e == 0x7ff)
+        return (b.u >> 63) && x != 0.0 ? make_nan() : x;
+    if (b.u >> 63)
+        return make_nan();
+
+    uint64_t m = b.u & DBL_MANT_MASK;
+    if (e == 0) {
+        // normalize a denormal input
+        e = 1;
+        while ((m & DBL_IMPLICIT_BIT) == 0) {
+            m <<= 1;
+            e--;
+        }
+    } else {
+        m |= DBL_IMPLICIT_BIT;
+    }
+
+    // value = m * 2^exp2, make exp2 even so sqrt halves it exactly
+    int exp2 = e - 1023 - 52;
+    if (exp2 & 1) {
+        m <<= 1;
+        exp2--;
+    }
+
+    // q = floor(sqrt(m * 2^52)), shifting the radicand in two bits at
+    // a time like long division
+    uint64_t rad = m << 10;
+    uint64_t q = 0;
+    uint64_t rem = 0;
+    for (int i = 0; i < 53; i++) {
+        rem = (rem << 2) | (rad >> 62);
+        rad <<= 2;
+        uint64_t t = (q << 2) | 1;
+        q <<= 1;
+        if (rem >= t) {
+            rem -= t;
+            q |= 1;
+        }
+    }
+    // round to nearest: the true root exceeds q + 1/2 iff rem > q
+    if (rem > q)
+        q++;
+
+    b.u = (q - DBL_IMPLICIT_BIT) | ((uint64_t)(exp2 / 2 + 26 + 1023) << 52);
+    return b.d;
+}
+
+// sin(k * pi/32) for k = 0..63; cos comes from the same table shifted
+// by a quarter turn
+static const double SIN_TAB[64] = {
+    0.0,                  0.0980171403295606,   0.19509032201612825,  0.29028467725446233,
+    0.3826834323650898,   0.47139673682599764,  0.5555702330196022,   0.6343932841636455,
+    0.7071067811865475,   0.773010453362737,    0.8314696123025452,   0.8819212643483549,
+    0.9238795325112867,   0.9569403357322089,   0.9807852804032304,   0.9951847266721968,
+    1.0,                  0.9951847266721969,   0.9807852804032304,   0.9569403357322089,
+    0.9238795325112867,   0.881921264348355,    0.8314696123025455,   0.7730104533627371,
+    0.7071067811865476,   0.6343932841636455,   0.5555702330196022,   0.47139673682599786,
+    0.3826834323650899,   0.2902846772544624,   0.1950903220161286,   0.09801714032956083,
+    0.0,                  -0.09801714032956059, -0.19509032201612836, -0.2902846772544621,
+    -0.38268343236508967, -0.47139673682599764, -0.555570233019602,   -0.6343932841636453,
+    -0.7071067811865475,  -0.7730104533627367,  -0.8314696123025452,  -0.8819212643483549,
+    -0.9238795325112865,  -0.9569403357322088,  -0.9807852804032303,  -0.9951847266721969,
+    -1.0,                 -0.9951847266721969,  -0.9807852804032304,  -0.9569403357322089,
+    -0.9238795325112866,  -0.881921264348355,   -0.8314696123025455,  -0.7730104533627369,
+    -0.7071067811865477,  -0.6343932841636459,  -0.5555702330196022,  -0.4713967368259979,
+    -0.3826834323650904,  -0.2902846772544625,  -0.19509032201612872, -0.0980171403295605,
+};
+
+#define TWO_PI 6.283185307179586
+#define INV_P32 10.185916357881302  // 32 / pi
+// pi/32 split in two so i * P32 subtracts exactly
+#define P32_HI 0.09817477042468103
+#define P32_LO 3.827021247335479e-18
+
+// shared kernel: reduce to the nearest table entry (step pi/32) and
+// rotate by the residual d with short Taylor polynomials; |d| <= pi/64
+// keeps both polynomials at three terms
+static double sin_cos(double x, int want_cos) {
+    int negate = 0;
+    if (x != x)
+        return x;
+    if (x < 0.0) {
+        x = -x;
+        if (!want_cos)
+            negate = 1;
+    }
+    if (x >= TWO_PI) {
+        x = fmod(x, TWO_PI);
+        if (x != x)
+            return x;  // inf reduces to NaN
+    }
+
+    int i = (int)(x * INV_P32 + 0.5);
+    double d = (x - (double)i * P32_HI) - (double)i * P32_LO;
+    i &= 63;
+
+    double d2 = d * d;
+    double sin_d = d * (1.0 - d2 * (1.0 / 6.0 - d2 * (1.0 / 120.0 - d2 * (1.0 / 5040.0))));
+    double cos_d = 1.0 - d2 * (0.5 - d2 * (1.0 / 24.0 - d2 * (1.0 / 720.0)));
+
+    double s = SIN_TAB[i];
+    double c = SIN_TAB[(i + 16) & 63];
+    double res = want_cos ? c * cos_d - s * sin_d : s * cos_d + c * sin_d;
+    return negate ? -res : res;
+}
+
+double sin(double x) {
+    return sin_cos(x, 0);
+}
+
+double cos(double x) {
+    return sin_cos(x, 1);
+}
+
+// ln2 split in two so k * LN2 subtracts exactly
+#define LN2_HI 0.6931471805599453
+#define LN2_LO 2.3190468138462996e-17
+#define INV_LN2 1.4426950408889634
+#define SQRT1_2 0.7071067811865476
+
+double exp(double x) {
+    if (x != x)
+        return x;
+    if (x > 709.782712893384)
+        return HUGE_VAL;
+    if (x < -745.2)
+        return 0.0;
+
+    // e^x = 2^k * e^r with |r| <= ln2 / 2
+    int k = (int)floor(x * INV_LN2 + 0.5);
+    double r = (x - (double)k * LN2_HI) - (double)k * LN2_LO;
+
+    double p = 1.0 / 479001600.0;  // 1/12!
+    p = p * r + 1.0 / 39916800.0;
+    p = p * r + 1.0 / 3628800.0;
+    p = p * r + 1.0 / 362880.0;
+    p = p * r + 1.0 / 40320.0;
+    p = p * r + 1.0 / 5040.0;
+    p = p * r + 1.0 / 720.0;
+    p = p * r + 1.0 / 120.0;
+    p = p * r + 1.0 / 24.0;
+    p = p * r + 1.0 / 6.0;
+    p = p * r + 0.5;
+    p = p * r + 1.0;
+    p = p * r + 1.0;
+    return ldexp(p, k);
+}
+
+double log(double x) {
+    if (x != x)
+        return x;
+    if (x < 0.0)
+        return make_nan();
+    if (x == 0.0)
+        return -HUGE_VAL;
+    if (x > 1.7e308)
+        return x;  // inf
+
+    // x = m * 2^e with m in [sqrt(1/2), sqrt(2)), then the atanh series
+    // log(m) = 2 * (s + s^3/3 + ...) with s = (m - 1) / (m + 1)
+    int e;
+    double m = frexp(x, &e);
+    if (m < SQRT1_2) {
+        m *= 2.0;
+        e--;
+    }
+
+    double s = (m - 1.0) / (m + 1.0);
+    double w = s * s;
+    double p = 1.0 / 17.0;
+    p = p * w + 1.0 / 15.0;
+    p = p * w + 1.0 / 13.0;
+    p = p * w + 1.0 / 11.0;
+    p = p * w + 1.0 / 9.0;
+    p = p * w + 1.0 / 7.0;
+    p = p * w + 1.0 / 5.0;
+    p = p * w + 1.0 / 3.0;
+    p = p * w + 1.0;
+    return (double)e * LN2_HI + (2.0 * s * p + (double)e * LN2_LO);
+}
+
+double pow(double x, double y) {
+    if (y == 0.0)
+        return 1.0;
+    if (x != x || y != y)
+        return make_nan();
+    if (x == 0.0)
+        return y > 0.0 ? 0.0 : HUGE_VAL;
+
+    // integer exponents (the common case in scripted code) go through
+    // exact repeated squaring and also cover negative bases
+    if (y == floor(y) && fabs(y) <= 2147483647.0) {
+        long n = (long)y;
+        int invert = n < 0;
+        if (invert)
+            n = -n;
+        double base = x;
+        double res = 1.0;
+        while (n > 0) {
+            if (n & 1)
+                res *= base;
+            base *= base;
+            n >>= 1;
+        }
+        return invert ? 1.0 / res : res;
+    }
+
+    if (x < 0.0)
+        return make_nan();
+    return exp(y * log(x));
+}
+
+double ldexp(double x, int exp) {
+    dbl_bits scale;
+
+    // clamp in steps so intermediate scales stay representable
+    if (exp > 1023) {
+        x *= 0x1p1023;
+        exp -= 1023;
+        if (exp > 1023) {
+            x *= 0x1p1023;
+            exp -= 1023;
+            if (exp > 1023)
+                exp = 1023;
+        }
+    } else if (exp < -1022) {
+        x *= 0x1p-1022 * 0x1p53;
+        exp += 1022 - 53;
+        if (exp < -1022) {
+            x *= 0x1p-1022 * 0x1p53;
+            exp += 1022 - 53;
+            if (exp < -1022)
+                exp = -1022;
+        }
+    }
+    scale.u = (uint64_t)(0x3ff + exp) << 52;
+    return x * scale.d;
+}
+
+double frexp(double x, int* exp) {
+    dbl_bits b = {.d = x};
+    int e = (int)((b.u >> 52) & 0x7ff);
+
+    if (e == 0) {
+        if (x == 0.0) {
+            *exp = 0;
+            return x;
+        }
+        // scale a denormal into the normal range first
+        x = frexp(x * 0x1p64, exp);
+        *exp -= 64;
+        return x;
+    }
+    if (e == 0x7ff) {
+        *exp = 0;
+        return x;
+    }
+
+    *exp = e - 1022;
+    b.u = (b.u & ~DBL_EXP_MASK) | (1022ull << 52);
+    return b.d;
 }
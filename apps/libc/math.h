@@ -1,12 +1,20 @@
 #ifndef _MATH_H
 #define _MATH_H
 
-long pow(long base, long exp);
-long ldexp(long x, int exp);
-long floor(long x);
-long frexp(long x, int* exp);
-long fmod(long x, long y);
+#define M_PI 3.14159265358979323846
+#define HUGE_VAL (__builtin_huge_val())
 
-#define HUGE_VAL 0
+double fabs(double x);
+double floor(double x);
+double ceil(double x);
+double fmod(double x, double y);
+double sqrt(double x);
+double sin(double x);
+double cos(double x);
+double exp(double x);
+double log(double x);
+double pow(double x, double y);
+double ldexp(double x, int exp);
+double frexp(double x, int* exp);
 
 #endif
@@ -0,0 +1,7 @@
+#include "sys/poll.h"
+
+#include "syscalls.h"
+
+int poll(pollfd* fds, size_t nfds, int timeout_ms) {
+    return sys_poll(fds, nfds, timeout_ms);
+}
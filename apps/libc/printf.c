@@ -6,38 +6,85 @@
 #include "string.h"
 #include "syscalls.h"
 
-#define BUF_SIZE 1000
-static char BUF[BUF_SIZE];
+// callback-driven formatter core: output goes through a sink so arbitrary
+// lengths stream without a fixed global buffer and concurrent formats
+// cannot corrupt each other
+typedef struct {
+    int (*write)(void* ctx, const char* s, size_t len);
+    void* ctx;
+    int written;  // characters produced (excluding the terminating NUL)
+    int error;
+} fmt_out;
+
+static void out_char(fmt_out* out, char c) {
+    if (out->error)
+        return;
+
+    if (out->write(out->ctx, &c, 1) == -1) {
+        out->error = 1;
+        return;
+    }
 
-int write_buf(char* buf, int buf_len, int write_len, char c) {
-    if (write_len >= buf_len)
-        return -1;
+    out->written++;
+}
+
+static void out_str(fmt_out* out, const char* s, size_t len) {
+    if (out->error || len == 0)
+        return;
+
+    if (out->write(out->ctx, s, len) == -1) {
+        out->error = 1;
+        return;
+    }
 
-    buf[write_len++] = c;
-    return write_len;
+    out->written += len;
 }
 
-int _printf(char* buf, int buf_len, const char* fmt, va_list ap) {
-    int ret = 0;
-    int str_len = strlen(fmt);
-    int str_i = 0;
-    int buf_i = 0;
+static void out_num(fmt_out* out, uint64_t va_num, int base, bool upper, bool is_negative, bool zero_fill, int min_width, int precision) {
+    if (is_negative) {
+        out_char(out, '-');
+    }
 
-    while (buf_i != -1 && ret != -1) {
-        if (str_i >= str_len || buf_i >= buf_len - 1) {
-            ret = write_buf(buf, buf_len, buf_i, '\0');
-            buf_i = -1;
-            break;
+    char num_str[32];
+    int num_len = 0;
+
+    if (va_num == 0) {
+        num_str[num_len++] = '0';
+    } else {
+        while (va_num > 0 && num_len < (int)sizeof(num_str)) {
+            int digit = va_num % base;
+            if (digit < 10) {
+                num_str[num_len++] = '0' + digit;
+            } else {
+                num_str[num_len++] = (upper ? 'A' : 'a') + digit - 10;
+            }
+            va_num /= base;
         }
+    }
+
+    for (int i = 0; i < (min_width > num_len ? min_width - num_len : 0); i++) {
+        char fill_char = zero_fill ? '0' : ' ';
+        out_char(out, fill_char);
+    }
+
+    for (int i = 0; i < (precision > num_len ? precision - num_len : 0); i++) {
+        out_char(out, '0');
+    }
+
+    for (int i = num_len - 1; i >= 0; i--) {
+        out_char(out, num_str[i]);
+    }
+}
+
+int _printf(fmt_out* out, const char* fmt, va_list ap) {
+    int str_len = strlen(fmt);
+    int str_i = 0;
 
+    while (str_i < str_len && !out->error) {
         char c = fmt[str_i++];
 
         if (c != '%') {
-            buf_i = write_buf(buf, buf_len, buf_i, c);
-            if (buf_i == -1) {
-                ret = -1;
-                break;
-            }
+            out_char(out, c);
             continue;
         }
 
@@ -81,35 +128,10 @@ int _printf(char* buf, int buf_len, const char* fmt, va_list ap) {
 
                 bool is_negative = va_num < 0;
                 if (is_negative) {
-                    buf_i = write_buf(buf, buf_len, buf_i, '-');
                     va_num = -va_num;
                 }
 
-                char num_str[32];
-                int num_len = 0;
-
-                if (va_num == 0) {
-                    num_str[num_len++] = '0';
-                } else {
-                    while (va_num > 0 && num_len < sizeof(num_str)) {
-                        num_str[num_len++] = '0' + (va_num % 10);
-                        va_num /= 10;
-                    }
-                }
-
-                for (int i = 0; i < (min_width > num_len ? min_width - num_len : 0); i++) {
-                    char fill_char = zero_fill ? '0' : ' ';
-                    buf_i = write_buf(buf, buf_len, buf_i, fill_char);
-                }
-
-                for (int i = 0; i < (precision > num_len ? precision - num_len : 0); i++) {
-                    buf_i = write_buf(buf, buf_len, buf_i, '0');
-                }
-
-                for (int i = num_len - 1; i >= 0; i--) {
-                    buf_i = write_buf(buf, buf_len, buf_i, num_str[i]);
-                }
-
+                out_num(out, (uint64_t)va_num, 10, false, is_negative, zero_fill, min_width, precision);
                 break;
             }
 
@@ -123,30 +145,7 @@ int _printf(char* buf, int buf_len, const char* fmt, va_list ap) {
                     va_num = va_arg(ap, unsigned int);
                 }
 
-                char num_str[32];
-                int num_len = 0;
-
-                if (va_num == 0) {
-                    num_str[num_len++] = '0';
-                } else {
-                    while (va_num > 0 && num_len < sizeof(num_str)) {
-                        num_str[num_len++] = '0' + (va_num % 10);
-                        va_num /= 10;
-                    }
-                }
-
-                for (int i = 0; i < (min_width > num_len ? min_width - num_len : 0); i++) {
-                    char fill_char = zero_fill ? '0' : ' ';
-                    buf_i = write_buf(buf, buf_len, buf_i, fill_char);
-                }
-
-                for (int i = 0; i < (precision > num_len ? precision - num_len : 0); i++) {
-                    buf_i = write_buf(buf, buf_len, buf_i, '0');
-                }
-
-                for (int i = num_len - 1; i >= 0; i--) {
-                    buf_i = write_buf(buf, buf_len, buf_i, num_str[i]);
-                }
+                out_num(out, va_num, 10, false, false, zero_fill, min_width, precision);
                 break;
             }
 
@@ -164,94 +163,113 @@ int _printf(char* buf, int buf_len, const char* fmt, va_list ap) {
                     va_num = va_arg(ap, unsigned int);
                 }
 
-                char num_str[32];
-                int num_len = 0;
-
-                if (va_num == 0) {
-                    num_str[num_len++] = '0';
-                } else {
-                    while (va_num > 0 && num_len < sizeof(num_str)) {
-                        int digit = va_num % 16;
-                        if (digit < 10) {
-                            num_str[num_len++] = '0' + digit;
-                        } else {
-                            num_str[num_len++] = (nc == 'x' || nc == 'p' ? 'a' : 'A') + digit - 10;
-                        }
-                        va_num /= 16;
-                    }
-                }
-
-                for (int i = 0; i < (min_width > num_len ? min_width - num_len : 0); i++) {
-                    char fill_char = zero_fill ? '0' : ' ';
-                    buf_i = write_buf(buf, buf_len, buf_i, fill_char);
-                }
-
-                for (int i = 0; i < (precision > num_len ? precision - num_len : 0); i++) {
-                    buf_i = write_buf(buf, buf_len, buf_i, '0');
-                }
-
-                for (int i = num_len - 1; i >= 0; i--) {
-                    buf_i = write_buf(buf, buf_len, buf_i, num_str[i]);
-                }
-
+                out_num(out, va_num, 16, nc == 'X', false, zero_fill, min_width, precision);
                 break;
             }
 
             case 'c': {
                 char va_c = va_arg(ap, int);
-                buf_i = write_buf(buf, buf_len, buf_i, va_c);
+                out_char(out, va_c);
                 break;
             }
 
             case 's': {
                 const char* va_s = va_arg(ap, char*);
                 if (va_s == NULL) {
-                    ret = -1;
-                    break;
+                    return -1;
                 }
 
-                int va_s_len = strlen(va_s);
-                for (int i = 0; i < va_s_len; i++) {
-                    buf_i = write_buf(buf, buf_len, buf_i, va_s[i]);
-                }
+                out_str(out, va_s, strlen(va_s));
                 break;
             }
 
             case '%':
-                buf_i = write_buf(buf, buf_len, buf_i, '%');
+                out_char(out, '%');
                 break;
 
             default:
-                ret = -1;
-                break;
+                return -1;
         }
     }
 
-    return ret;
+    if (out->error)
+        return -1;
+
+    return out->written;
 }
 
-int printf(const char* fmt, ...) {
-    va_list ap;
-    va_start(ap, fmt);
-    int ret = _printf(BUF, BUF_SIZE, fmt, ap);
+// sink writing into a bounded buffer; keeps counting past the truncation
+// point so callers learn the full length
+typedef struct {
+    char* buf;
+    size_t size;
+    size_t len;
+} buf_sink_ctx;
 
-    if (ret == -1) {
-        ret = _printf(BUF, BUF_SIZE, "<PRINTF ERROR>\n", ap);
+static int buf_sink(void* ctx, const char* s, size_t len) {
+    buf_sink_ctx* b = (buf_sink_ctx*)ctx;
+
+    for (size_t i = 0; i < len; i++) {
+        if (b->size > 0 && b->len < b->size - 1) {
+            b->buf[b->len] = s[i];
+        }
+        b->len++;
     }
-    va_end(ap);
 
-    if (ret != -1) {
-        ret = sys_write(FDN_STDOUT, BUF, strlen(BUF));
+    return 0;
+}
+
+// sink streaming through the buffered FILE layer in chunks
+#define STREAM_SINK_CHUNK 256
+
+typedef struct {
+    FILE* stream;
+    char chunk[STREAM_SINK_CHUNK];
+    size_t len;
+} stream_sink_ctx;
+
+static int stream_sink_flush(stream_sink_ctx* s) {
+    if (s->len == 0)
+        return 0;
+
+    size_t written = fwrite(s->chunk, 1, s->len, s->stream);
+    if (written < s->len)
+        return -1;
+
+    s->len = 0;
+    return 0;
+}
+
+static int stream_sink(void* ctx, const char* s, size_t len) {
+    stream_sink_ctx* sink = (stream_sink_ctx*)ctx;
+
+    for (size_t i = 0; i < len; i++) {
+        if (sink->len == STREAM_SINK_CHUNK && stream_sink_flush(sink) == -1)
+            return -1;
+
+        sink->chunk[sink->len++] = s[i];
     }
 
+    return 0;
+}
+
+int printf(const char* fmt, ...) {
+    va_list ap;
+    va_start(ap, fmt);
+    int ret = vfprintf(stdout, fmt, ap);
+    va_end(ap);
     return ret;
 }
 
 int vsnprintf(char* buf, size_t bufsize, const char* format, va_list arg) {
-    int ret = _printf(buf, bufsize, format, arg);
+    buf_sink_ctx ctx = {.buf = buf, .size = bufsize, .len = 0};
+    fmt_out out = {.write = buf_sink, .ctx = &ctx, .written = 0, .error = 0};
+
+    int ret = _printf(&out, format, arg);
 
-    if (ret != -1) {
-        ret = strlen(buf);
+    if (bufsize > 0) {
+        size_t end = ctx.len < bufsize - 1 ? ctx.len : bufsize - 1;
+        buf[end] = '\0';
     }
 
     return ret;
@@ -260,13 +278,8 @@ int vsnprintf(char* buf, size_t bufsize, const char* format, va_list arg) {
 int snprintf(char* buf, size_t size, const char* format, ...) {
     va_list ap;
     va_start(ap, format);
-    int ret = _printf(buf, size, format, ap);
+    int ret = vsnprintf(buf, size, format, ap);
     va_end(ap);
-
-    if (ret != -1) {
-        ret = strlen(buf);
-    }
-
     return ret;
 }
 
@@ -283,17 +296,14 @@ int vfprintf(FILE* stream, const char* fmt, va_list ap) {
         return -1;
     }
 
-    char buf[1024];
-    int len = vsnprintf(buf, sizeof(buf), fmt, ap);
+    stream_sink_ctx ctx = {.stream = stream, .len = 0};
+    fmt_out out = {.write = stream_sink, .ctx = &ctx, .written = 0, .error = 0};
 
-    if (len < 0) {
-        return -1;
-    }
+    int ret = _printf(&out, fmt, ap);
 
-    size_t written = fwrite(buf, 1, len, stream);
-    if (written < (size_t)len) {
+    if (stream_sink_flush(&ctx) == -1) {
         return -1;
     }
 
-    return len;
+    return ret;
 }
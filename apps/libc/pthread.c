@@ -0,0 +1,63 @@
+#include "pthread.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "errno.h"
+#include "stdlib.h"
+#include "syscalls.h"
+
+typedef struct {
+    void* (*start_routine)(void*);
+    void* arg;
+} thread_start;
+
+// runs on the new thread's stack; the return value travels back to
+// pthread_join through the task exit code
+static void __thread_entry(void* arg) {
+    thread_start* start = (thread_start*)arg;
+    void* (*start_routine)(void*) = start->start_routine;
+    void* start_arg = start->arg;
+    free(start);
+
+    void* ret = start_routine(start_arg);
+    __errno_release();
+    sys_exit((int)(intptr_t)ret);
+}
+
+int pthread_create(pthread_t* thread, const void* attr, void* (*start_routine)(void*), void* arg) {
+    (void)attr;
+
+    thread_start* start = (thread_start*)malloc(sizeof(thread_start));
+    if (start == NULL)
+        return -1;
+
+    start->start_routine = start_routine;
+    start->arg = arg;
+
+    pid_t tid = sys_thread_create(__thread_entry, start);
+    if (tid < 0) {
+        free(start);
+        return -1;
+    }
+
+    if (thread != NULL)
+        *thread = tid;
+
+    return 0;
+}
+
+int pthread_join(pthread_t thread, void** retval) {
+    int exit_code = sys_thread_join(thread);
+    if (exit_code < 0)
+        return -1;
+
+    if (retval != NULL)
+        *retval = (void*)(intptr_t)exit_code;
+
+    return 0;
+}
+
+pthread_t pthread_self(void) {
+    return sys_getpid();
+}
@@ -0,0 +1,13 @@
+#ifndef _PTHREAD_H
+#define _PTHREAD_H
+
+#include "sys/types.h"
+
+// threads are tasks, so a thread id is just a pid
+typedef pid_t pthread_t;
+
+int pthread_create(pthread_t* thread, const void* attr, void* (*start_routine)(void*), void* arg);
+int pthread_join(pthread_t thread, void** retval);
+pthread_t pthread_self(void);
+
+#endif
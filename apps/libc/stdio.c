@@ -33,7 +33,58 @@ FILE* stdin = &__stdin;
 FILE* stdout = &__stdout;
 FILE* stderr = &__stderr;
 
+// every fopen'd stream, linked through FILE.next; fflush(NULL) walks it
+static FILE* open_streams = NULL;
+
+// flush buffered write data to the fd
+static int stream_flush_write(FILE* stream) {
+    if (stream->buf == NULL || !stream->buf_dirty)
+        return 0;
+
+    size_t len = stream->buf_pos;
+    stream->buf_pos = 0;
+    stream->buf_dirty = 0;
+
+    if (len == 0)
+        return 0;
+
+    if (stream->fd == FDN_STDOUT || stream->fd == FDN_STDERR) {
+        if (sys_write(stream->fd, stream->buf, len) != (int)len) {
+            stream->flags |= _FILE_ERR_FLAG;
+            return -1;
+        }
+    } else {
+        if (sys_pwrite(stream->fd, stream->buf, len, (off_t)stream->buf_file_pos) != (int)len) {
+            stream->flags |= _FILE_ERR_FLAG;
+            return -1;
+        }
+        stream->buf_file_pos += (long int)len;
+    }
+
+    return 0;
+}
+
+// allocate the stream buffer lazily on first buffered access
+static int stream_ensure_buf(FILE* stream) {
+    if (stream->buf != NULL)
+        return 0;
+
+    if (stream->buf_mode == _IONBF)
+        return -1;
+
+    if (stream->buf_size == 0)
+        stream->buf_size = BUFSIZ;
+
+    stream->buf = (char*)malloc(stream->buf_size);
+    if (stream->buf == NULL)
+        return -1;
+
+    stream->buf_owned = 1;
+    return 0;
+}
+
 void exit(int status) {
+    fflush(NULL);
     sys_exit((uint64_t)status);
 }
 
@@ -44,14 +95,14 @@ FILE* fopen(const char* filepath, const char* mode) {
         flags |= OPEN_FLAG_CREATE;
     }
 
-    int fd = sys_open(filepath, flags);
-    if (fd == -1)
+    f_stat* stat = (f_stat*)malloc(sizeof(f_stat));
+    if (stat == NULL)
         return NULL;
 
-    f_stat* stat = (f_stat*)malloc(sizeof(f_stat));
-    if (sys_stat(fd, stat) == -1) {
+    // one syscall and one path lookup for open+stat
+    int fd = sys_openstat(filepath, (int)flags, stat);
+    if (fd == -1) {
         free(stat);
-        sys_close(fd);
         return NULL;
     }
 
@@ -60,6 +111,16 @@ FILE* fopen(const char* filepath, const char* mode) {
     file->stat = stat;
     file->pos = 0;
     file->flags = 0;
+    file->buf = NULL;
+    file->buf_size = 0;
+    file->buf_pos = 0;
+    file->buf_len = 0;
+    file->buf_mode = _IOFBF;
+    file->buf_owned = 0;
+    file->buf_dirty = 0;
+    file->buf_file_pos = 0;
+    file->next = open_streams;
+    open_streams = file;
     return file;
 }
 
@@ -67,10 +128,22 @@ int fclose(FILE* stream) {
     if (stream == NULL)
         return -1;
 
+    stream_flush_write(stream);
+
+    for (FILE** link = &open_streams; *link != NULL; link = &(*link)->next) {
+        if (*link == stream) {
+            *link = stream->next;
+            break;
+        }
+    }
+
     int64_t res = sys_close(stream->fd);
     if (res == -1)
         return -1;
 
+    if (stream->buf_owned)
+        free(stream->buf);
+
     if (stream->stat != NULL)
         free(stream->stat);
 
@@ -86,21 +159,33 @@ long int ftell(FILE* stream) {
 }
 
 int fflush(FILE* stream) {
-    if (stream == NULL)
-        return -1;
+    // NULL flushes every open stream - the standard ones plus the
+    // fopen registry - so buffered data survives exit without an
+    // explicit fclose
+    if (stream == NULL) {
+        int ret = 0;
+        if (stream_flush_write(stdout) == -1)
+            ret = -1;
+        if (stream_flush_write(stderr) == -1)
+            ret = -1;
+        for (FILE* f = open_streams; f != NULL; f = f->next) {
+            if (stream_flush_write(f) == -1)
+                ret = -1;
+        }
+        return ret;
+    }
 
-    // no-op
-    return 0;
+    return stream_flush_write(stream);
 }
 
 int puts(const char* c) {
-    int ret = sys_write(FDN_STDOUT, c, strlen(c));
-
-    if (ret == -1)
-        return -1;
+    // body and newline in one kernel crossing
+    iovec iov[2] = {
+        {.iov_base = (void*)c, .iov_len = strlen(c)},
+        {.iov_base = "\n", .iov_len = 1},
+    };
 
-    ret = sys_write(FDN_STDOUT, "\n", 1);
-    if (ret == -1)
+    if (sys_writev(FDN_STDOUT, iov, 2) == -1)
         return -1;
 
     return 0;
@@ -158,31 +243,94 @@ size_t fread(void* buf, size_t size, size_t count, FILE* stream) {
         return read_bytes / size;
     }
 
-    size_t total = size * count;
-    int ret = sys_read(stream->fd, buf, total);
-    if (ret <= 0) {
-        stream->flags |= _FILE_EOF_FLAG;
+    if (stream->buf_dirty && stream_flush_write(stream) == -1)
         return 0;
+
+    size_t total = size * count;
+    size_t read_bytes = 0;
+    char* dst = (char*)buf;
+
+    // serve remaining read-ahead data first
+    if (stream->buf != NULL && stream->buf_pos < stream->buf_len) {
+        size_t avail = stream->buf_len - stream->buf_pos;
+        size_t chunk = total < avail ? total : avail;
+        memcpy(dst, stream->buf + stream->buf_pos, chunk);
+        stream->buf_pos += chunk;
+        read_bytes += chunk;
     }
 
-    stream->pos += ret;
+    while (read_bytes < total) {
+        size_t remain = total - read_bytes;
+
+        // read ahead a full buffer for requests smaller than the buffer,
+        // otherwise read straight into the caller's buffer
+        if (stream->buf_mode != _IONBF && stream_ensure_buf(stream) == 0 &&
+            remain < stream->buf_size) {
+            int ret = sys_pread(stream->fd, stream->buf, stream->buf_size,
+                                (off_t)(stream->pos + (long int)read_bytes));
+            if (ret <= 0) {
+                stream->flags |= _FILE_EOF_FLAG;
+                break;
+            }
+
+            stream->buf_len = (size_t)ret;
+            size_t chunk = remain < (size_t)ret ? remain : (size_t)ret;
+            memcpy(dst + read_bytes, stream->buf, chunk);
+            stream->buf_pos = chunk;
+            read_bytes += chunk;
+        } else {
+            int ret = sys_pread(stream->fd, dst + read_bytes, remain,
+                                (off_t)(stream->pos + (long int)read_bytes));
+            if (ret <= 0) {
+                stream->flags |= _FILE_EOF_FLAG;
+                break;
+            }
+
+            read_bytes += (size_t)ret;
 
-    if ((size_t)ret < total) {
-        stream->flags |= _FILE_EOF_FLAG;
+            if ((size_t)ret < remain) {
+                stream->flags |= _FILE_EOF_FLAG;
+                break;
+            }
+        }
     }
 
-    return (size_t)ret / size;
+    stream->pos += read_bytes;
+    return read_bytes / size;
 }
 
 int fseek(FILE* stream, long int offset, int whence) {
     if (stream == NULL || stream->fd == FDN_STDIN)
         return -1;
 
-    off_t new_pos = sys_lseek(stream->fd, (off_t)offset, whence);
-    if (new_pos < 0)
+    if (stream_flush_write(stream) == -1)
+        return -1;
+
+    // reads and writes are positional, so a seek is pure bookkeeping -
+    // no syscall and no shared fd position to move
+    long int target;
+    if (whence == SEEK_SET) {
+        target = offset;
+    } else if (whence == SEEK_CUR) {
+        target = stream->pos + offset;
+    } else if (whence == SEEK_END) {
+        // re-stat for the current size; the one from fopen may be stale
+        f_stat st;
+        if (sys_stat(stream->fd, &st) == -1)
+            return -1;
+        target = (long int)st.size + offset;
+    } else {
+        return -1;
+    }
+
+    if (target < 0)
         return -1;
 
-    stream->pos = (long int)new_pos;
+    // invalidate read-ahead data
+    stream->buf_pos = 0;
+    stream->buf_len = 0;
+
+    stream->pos = target;
     stream->flags &= ~_FILE_EOF_FLAG;
     return 0;
 }
@@ -195,19 +343,113 @@ size_t fwrite(const void* buf, size_t size, size_t count, FILE* stream) {
         return 0;
 
     size_t total = size * count;
-    int res = sys_write(stream->fd, buf, total);
-    if (res == -1)
-        return 0;
+
+    // unbuffered path
+    if (stream->buf_mode == _IONBF || stream_ensure_buf(stream) == -1) {
+        int res;
+        if (stream->fd == FDN_STDOUT || stream->fd == FDN_STDERR) {
+            res = sys_write(stream->fd, buf, total);
+        } else {
+            res = sys_pwrite(stream->fd, buf, total, (off_t)stream->pos);
+        }
+        if (res == -1)
+            return 0;
+
+        if (stream->fd != FDN_STDOUT && stream->fd != FDN_STDERR) {
+            stream->pos += res;
+        }
+
+        return (size_t)res / size;
+    }
+
+    // drop read-ahead data before switching the buffer to writing
+    if (!stream->buf_dirty && stream->buf_len > 0) {
+        stream->buf_pos = 0;
+        stream->buf_len = 0;
+    }
+
+    const char* src = (const char*)buf;
+    size_t remain = total;
+
+    while (remain > 0) {
+        // bypass the buffer for writes that would fill it anyway
+        if (stream->buf_pos == 0 && remain >= stream->buf_size) {
+            int res;
+            if (stream->fd == FDN_STDOUT || stream->fd == FDN_STDERR) {
+                res = sys_write(stream->fd, src, remain);
+            } else {
+                long int at = stream->pos + (long int)(total - remain);
+                res = sys_pwrite(stream->fd, src, remain, (off_t)at);
+            }
+            if (res != (int)remain) {
+                stream->flags |= _FILE_ERR_FLAG;
+                return 0;
+            }
+            remain = 0;
+            break;
+        }
+
+        if (stream->buf_pos == stream->buf_size) {
+            if (stream_flush_write(stream) == -1)
+                return 0;
+            continue;
+        }
+
+        size_t space = stream->buf_size - stream->buf_pos;
+        size_t chunk = remain < space ? remain : space;
+
+        // record where this run of buffered data lands in the file
+        if (!stream->buf_dirty && stream->buf_pos == 0)
+            stream->buf_file_pos = stream->pos + (long int)(total - remain);
+
+        memcpy(stream->buf + stream->buf_pos, src, chunk);
+        stream->buf_pos += chunk;
+        stream->buf_dirty = 1;
+        src += chunk;
+        remain -= chunk;
+    }
+
+    if (stream->buf_mode == _IOLBF && memchr(buf, '\n', total) != NULL) {
+        if (stream_flush_write(stream) == -1)
+            return 0;
+    }
 
     if (stream->fd != FDN_STDOUT && stream->fd != FDN_STDERR) {
-        stream->pos += res;
+        stream->pos += total;
     }
 
-    return (size_t)res / size;
+    return count;
 }
 
 int setvbuf(FILE* stream, char* buf, int mode, size_t size) {
-    printf("[DEBUG]setvbuf called\n");
+    if (stream == NULL)
+        return -1;
+
+    if (mode != _IONBF && mode != _IOLBF && mode != _IOFBF)
+        return -1;
+
+    if (stream_flush_write(stream) == -1)
+        return -1;
+
+    if (stream->buf_owned)
+        free(stream->buf);
+
+    stream->buf = NULL;
+    stream->buf_size = 0;
+    stream->buf_pos = 0;
+    stream->buf_len = 0;
+    stream->buf_owned = 0;
+    stream->buf_dirty = 0;
+    stream->buf_mode = mode;
+
+    if (mode == _IONBF)
+        return 0;
+
+    if (buf != NULL) {
+        stream->buf = buf;
+    }
+    // with no caller buffer, stream_ensure_buf allocates on first access
+    stream->buf_size = size > 0 ? size : BUFSIZ;
     return 0;
 }
 
@@ -242,6 +484,15 @@ int ungetc(int c, FILE* stream) {
 }
 
 int getc(FILE* stream) {
+    if (stream == NULL)
+        return EOF;
+
+    // fast path: unread byte already in the stream buffer
+    if (!stream->buf_dirty && stream->buf_pos < stream->buf_len) {
+        stream->pos++;
+        return (unsigned char)stream->buf[stream->buf_pos++];
+    }
+
     unsigned char c;
     if (fread(&c, 1, 1, stream) == 1) {
         return c;
@@ -250,19 +501,38 @@ int getc(FILE* stream) {
 }
 
 char* fgets(char* s, int size, FILE* stream) {
-    if (size <= 0) return NULL;
+    if (stream == NULL || size <= 0) return NULL;
 
-    char* p = s;
-    int c;
     int i = 0;
 
     while (i < size - 1) {
-        c = getc(stream);
+        // fast path: scan buffered data for the newline and copy in bulk
+        if (!stream->buf_dirty && stream->buf_pos < stream->buf_len) {
+            size_t avail = stream->buf_len - stream->buf_pos;
+            size_t want = (size_t)(size - 1 - i);
+            size_t chunk = avail < want ? avail : want;
+
+            char* nl = (char*)memchr(stream->buf + stream->buf_pos, '\n', chunk);
+            if (nl != NULL)
+                chunk = (size_t)(nl - (stream->buf + stream->buf_pos)) + 1;
+
+            memcpy(s + i, stream->buf + stream->buf_pos, chunk);
+            stream->buf_pos += chunk;
+            stream->pos += chunk;
+            i += (int)chunk;
+
+            if (nl != NULL)
+                break;
+
+            continue;
+        }
+
+        // slow path: one byte at a time (refills the buffer for files)
+        int c = getc(stream);
         if (c == EOF) {
             break;
         }
-        *p++ = (char)c;
-        i++;
+        s[i++] = (char)c;
         if (c == '\n') {
             break;
         }
@@ -270,7 +540,7 @@ char* fgets(char* s, int size, FILE* stream) {
 
     if (i == 0) return NULL;
 
-    *p = '\0';
+    s[i] = '\0';
     return s;
 }
 
@@ -21,12 +21,28 @@
 #define _FILE_EOF_FLAG 0x01
 #define _FILE_ERR_FLAG 0x02
 
-typedef struct
+typedef struct _FILE
 {
     int fd;
     f_stat* stat;
     long int pos;
     int flags;
+    // stream buffer (NULL = unbuffered); holds either unwritten data
+    // (buf_dirty set, buf_pos bytes pending) or read-ahead data
+    // (buf_len valid bytes, buf_pos consumed)
+    char* buf;
+    size_t buf_size;
+    size_t buf_pos;
+    size_t buf_len;
+    int buf_mode;   // _IONBF / _IOLBF / _IOFBF
+    int buf_owned;  // buffer was allocated by stdio
+    int buf_dirty;
+    // file offset where buffered write data begins; file I/O is
+    // positional (sys_pread/sys_pwrite), so the shared kernel fd
+    // position is never relied on
+    long int buf_file_pos;
+    // open-stream registry, so fflush(NULL) reaches every fopen'd FILE
+    struct _FILE* next;
 } FILE;
 
 extern FILE* stdin;
@@ -2,6 +2,7 @@
 
 #include <limits.h>
 #include <stddef.h>
+#include <stdint.h>
 
 #include "ctype.h"
 #include "stdio.h"  // for printf
@@ -14,11 +15,40 @@
 
 typedef struct FreeBlock {
     size_t size;
+    struct FreeBlock* span;  // start of the sbrk span this block was carved from
     struct FreeBlock* next;
 } FreeBlock;
 
-// simple first-fit allocator
-static FreeBlock* free_list = NULL;
+// segregated free lists: small requests are served from per-size-class bins
+// (32..4096 bytes total, header included) in O(1), larger requests fall back
+// to a first-fit large list
+#define BIN_MIN_SHIFT 5  // 32 bytes
+#define BIN_COUNT 8      // 32, 64, ..., 4096
+#define BIN_MAX_SIZE ((size_t)1 << (BIN_MIN_SHIFT + BIN_COUNT - 1))
+
+static FreeBlock* bins[BIN_COUNT] = {NULL};
+static FreeBlock* large_list = NULL;
+
+// bytes obtained from sys_sbrk and not yet returned; everything else in
+// malloc_stats is derived by walking the free lists on demand, so the
+// allocation hot paths carry no extra bookkeeping
+static size_t sbrk_total = 0;
+
+static malloc_sample_fn sample_fn = NULL;
+static size_t sample_min_size = 0;
+static size_t sample_interval = 1;
+static size_t sample_countdown = 1;
+
+static void malloc_sample(void* caller, size_t len) {
+    if (sample_fn == NULL || len < sample_min_size)
+        return;
+
+    if (--sample_countdown > 0)
+        return;
+
+    sample_countdown = sample_interval;
+    sample_fn(caller, len);
+}
 
 static FreeBlock* request_mem(size_t need) {
     size_t total = (need + sizeof(FreeBlock) + (ALIGN - 1)) & ~(ALIGN - 1);
@@ -31,8 +61,17 @@ static FreeBlock* request_mem(size_t need) {
     if (ptr == (void*)-1)
         return NULL;
 
+    // the kernel hands out whole pages; track the actual span size so a
+    // fully freed span can be returned via sys_free later
+    size_t span_size = sys_sbrksz(ptr);
+    if (span_size == 0)
+        span_size = total;
+
+    sbrk_total += span_size;
+
     FreeBlock* block = (FreeBlock*)ptr;
-    block->size = total;
+    block->size = span_size;
+    block->span = block;
     block->next = NULL;
     return block;
 }
@@ -46,20 +85,126 @@ static void split_block(FreeBlock* block, size_t need) {
 
     FreeBlock* new_block = (FreeBlock*)((char*)block + need);
     new_block->size = remain;
+    new_block->span = block->span;
     new_block->next = block->next;
 
     block->size = need;
     block->next = new_block;
 }
 
+// smallest bin whose block size holds `need` (total size), -1 if too large
+static int bin_index(size_t need) {
+    size_t size = (size_t)1 << BIN_MIN_SHIFT;
+    int i = 0;
+
+    while (size < need) {
+        size <<= 1;
+        i++;
+    }
+
+    return i < BIN_COUNT ? i : -1;
+}
+
+// bin for an exact class-sized free block, -1 if it belongs to the large list
+static int bin_index_exact(size_t size) {
+    if (size < ((size_t)1 << BIN_MIN_SHIFT) || size > BIN_MAX_SIZE)
+        return -1;
+
+    if ((size & (size - 1)) != 0)
+        return -1;
+
+    int i = 0;
+    while (((size_t)1 << (BIN_MIN_SHIFT + i)) != size)
+        i++;
+
+    return i;
+}
+
+// carve fresh memory into class-sized blocks and thread them onto the bin
+static int refill_bin(int bin) {
+    size_t block_size = (size_t)1 << (BIN_MIN_SHIFT + bin);
+
+    FreeBlock* mem = request_mem(block_size);
+    if (mem == NULL)
+        return -1;
+
+    size_t count = mem->size / block_size;
+    char* p = (char*)mem;
+
+    for (size_t i = 0; i < count; i++) {
+        FreeBlock* block = (FreeBlock*)(p + i * block_size);
+        block->size = block_size;
+        block->span = mem;
+        block->next = bins[bin];
+        bins[bin] = block;
+    }
+
+    return 0;
+}
+
+// insert into the address-ordered large list, merging with physically
+// adjacent free blocks; a fully reassembled sbrk span is handed back to
+// the kernel instead of being kept on the list
+static void large_insert(FreeBlock* block) {
+    FreeBlock** link = &large_list;
+    FreeBlock* before = NULL;
+    FreeBlock** before_link = NULL;
+
+    while (*link && *link < block) {
+        before = *link;
+        before_link = link;
+        link = &before->next;
+    }
+
+    FreeBlock* after = *link;
+
+    // merge with the physically following free block
+    if (after && (char*)block + block->size == (char*)after) {
+        block->size += after->size;
+        after = after->next;
+    }
+
+    // merge with the physically preceding free block
+    if (before && (char*)before + before->size == (char*)block) {
+        before->size += block->size;
+        before->next = after;
+        block = before;
+        link = before_link;
+    } else {
+        block->next = after;
+        *link = block;
+    }
+
+    if (block->span == block && sys_sbrksz(block) == block->size) {
+        *link = block->next;
+        sbrk_total -= block->size;
+        sys_free(block);
+    }
+}
+
 void* malloc(size_t len) {
     if (len == 0)
         return NULL;
 
+    void* caller = __builtin_return_address(0);
     size_t need = (len + sizeof(FreeBlock) + (ALIGN - 1)) & ~(ALIGN - 1);
 
-    FreeBlock** prev = &free_list;
-    FreeBlock* curr = free_list;
+    // fast path: pop a class-sized block in O(1)
+    int bin = bin_index(need);
+    if (bin >= 0) {
+        if (bins[bin] == NULL && refill_bin(bin) < 0)
+            return NULL;
+
+        FreeBlock* block = bins[bin];
+        bins[bin] = block->next;
+        block->next = NULL;
+        malloc_sample(caller, len);
+        return (void*)((char*)block + sizeof(FreeBlock));
+    }
+
+    // large path: first-fit over the large list
+    FreeBlock** prev = &large_list;
+    FreeBlock* curr = large_list;
 
     // find block
     while (curr) {
@@ -67,6 +212,7 @@ void* malloc(size_t len) {
             split_block(curr, need);
 
             *prev = curr->next;
+            malloc_sample(caller, len);
             return (void*)((char*)curr + sizeof(FreeBlock));
         }
 
@@ -82,12 +228,11 @@ void* malloc(size_t len) {
 
     if (new_block->next != NULL) {
         FreeBlock* remain = new_block->next;
-        remain->next = free_list;
-        free_list = remain;
-
         new_block->next = NULL;
+        large_insert(remain);
     }
 
+    malloc_sample(caller, len);
     return (void*)((char*)new_block + sizeof(FreeBlock));
 }
 
@@ -96,8 +241,15 @@ void free(void* ptr) {
         return;
 
     FreeBlock* block = (FreeBlock*)((char*)ptr - sizeof(FreeBlock));
-    block->next = free_list;
-    free_list = block;
+
+    int bin = bin_index_exact(block->size);
+    if (bin >= 0) {
+        block->next = bins[bin];
+        bins[bin] = block;
+        return;
+    }
+
+    large_insert(block);
 }
 
 void* calloc(size_t count, size_t size) {
@@ -126,6 +278,32 @@ void* realloc(void* ptr, size_t size) {
         return ptr;
     }
 
+    // try in-place growth: absorb the physically following free block
+    size_t need = (size + sizeof(FreeBlock) + (ALIGN - 1)) & ~(ALIGN - 1);
+
+    FreeBlock** link = &large_list;
+    while (*link && *link < block)
+        link = &(*link)->next;
+
+    FreeBlock* neighbor = *link;
+    if (neighbor && (char*)block + block->size == (char*)neighbor &&
+        neighbor->span == block->span &&
+        block->size + neighbor->size >= need) {
+        *link = neighbor->next;
+        block->size += neighbor->size;
+        block->next = NULL;
+
+        // give back the tail beyond the request
+        split_block(block, need);
+        if (block->next != NULL) {
+            FreeBlock* remain = block->next;
+            block->next = NULL;
+            large_insert(remain);
+        }
+
+        return ptr;
+    }
+
     void* new_ptr = malloc(size);
     if (!new_ptr) return NULL;
 
@@ -134,6 +312,88 @@ void* realloc(void* ptr, size_t size) {
     return new_ptr;
 }
 
+static void count_free_list(const FreeBlock* block, malloc_stats_t* st) {
+    for (; block != NULL; block = block->next) {
+        st->free_bytes += block->size;
+        st->free_blocks++;
+        if (block->size > st->largest_free)
+            st->largest_free = block->size;
+    }
+}
+
+// walks the free lists; every sbrk'd byte is either on a free list or
+// in use, so in_use_bytes falls out of the difference
+void malloc_stats(malloc_stats_t* st) {
+    if (st == NULL)
+        return;
+
+    memset(st, 0, sizeof(*st));
+
+    for (int i = 0; i < BIN_COUNT; i++)
+        count_free_list(bins[i], st);
+    count_free_list(large_list, st);
+
+    st->sbrk_bytes = sbrk_total;
+    st->in_use_bytes = sbrk_total - st->free_bytes;
+}
+
+void malloc_set_sample_hook(malloc_sample_fn fn, size_t min_size, size_t interval) {
+    sample_fn = fn;
+    sample_min_size = min_size;
+    sample_interval = interval > 0 ? interval : 1;
+    sample_countdown = sample_interval;
+}
+
+// --------------------------------------------------------------
+
+// arena allocator
+arena* arena_create(size_t size) {
+    if (size == 0)
+        return NULL;
+
+    arena* a = (arena*)malloc(sizeof(arena));
+    if (a == NULL)
+        return NULL;
+
+    a->base = (char*)malloc(size);
+    if (a->base == NULL) {
+        free(a);
+        return NULL;
+    }
+
+    a->size = size;
+    a->used = 0;
+    return a;
+}
+
+void* arena_alloc(arena* a, size_t len) {
+    if (a == NULL || len == 0)
+        return NULL;
+
+    size_t need = (len + (ALIGN - 1)) & ~(ALIGN - 1);
+    if (a->used + need > a->size)
+        return NULL;
+
+    void* ptr = a->base + a->used;
+    a->used += need;
+    return ptr;
+}
+
+void arena_reset(arena* a) {
+    if (a == NULL)
+        return;
+
+    a->used = 0;
+}
+
+void arena_destroy(arena* a) {
+    if (a == NULL)
+        return;
+
+    free(a->base);
+    free(a);
+}
+
 // --------------------------------------------------------------
 
 int abs(int i) {
@@ -141,13 +401,11 @@ int abs(int i) {
 }
 
 int atoi(const char* str) {
-    printf("[DEBUG]atoi called\n");
-    return -1;
+    return (int)strtol(str, NULL, 10);
 }
 
 double atof(const char* nptr) {
-    printf("[DEBUG]atof called\n");
-    return -1.0;
+    return strtod(nptr, NULL);
 }
 
 int system(const char* command) {
@@ -234,3 +492,222 @@ long strtol(const char* nptr, char** endptr, int base) {
         *endptr = (char*)(any ? s - 1 : nptr);
     return (acc);
 }
+
+// exact doubles for 10^0 .. 10^22 (the largest power of ten a double
+// represents exactly)
+static const double POW10_TAB[] = {
+    1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10,
+    1e11, 1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22,
+};
+
+double strtod(const char* nptr, char** endptr) {
+    const char* s = nptr;
+    uint64_t mant = 0;
+    int exp10 = 0;
+    int neg = 0, seen_digit = 0, seen_point = 0;
+
+    while (isspace(*s))
+        s++;
+
+    if (*s == '-') {
+        neg = 1;
+        s++;
+    } else if (*s == '+') {
+        s++;
+    }
+
+    // accumulate up to 19 significant digits into a uint64; further
+    // digits only shift the decimal exponent
+    for (;; s++) {
+        if (isdigit(*s)) {
+            seen_digit = 1;
+            if (mant <= (UINT64_MAX - 9) / 10) {
+                mant = mant * 10 + (uint64_t)(*s - '0');
+                if (seen_point)
+                    exp10--;
+            } else if (!seen_point) {
+                exp10++;
+            }
+        } else if (*s == '.' && !seen_point) {
+            seen_point = 1;
+        } else {
+            break;
+        }
+    }
+
+    if (!seen_digit) {
+        if (endptr != NULL)
+            *endptr = (char*)nptr;
+        return 0.0;
+    }
+
+    // exponent part, only consumed if digits actually follow
+    if (*s == 'e' || *s == 'E') {
+        char* exp_end;
+        long e = strtol(s + 1, &exp_end, 10);
+        if (exp_end != s + 1) {
+            // any |exponent| past this is an overflow/underflow anyway
+            if (e > 10000)
+                e = 10000;
+            if (e < -10000)
+                e = -10000;
+            exp10 += (int)e;
+            s = exp_end;
+        }
+    }
+
+    if (endptr != NULL)
+        *endptr = (char*)s;
+
+    if (mant == 0)
+        return neg ? -0.0 : 0.0;
+
+    double val = (double)mant;
+
+    // fast path: mantissa and power of ten both exact, so a single
+    // multiply or divide gives the correctly rounded result
+    if (mant < (1ull << 53) && exp10 >= -22 && exp10 <= 22) {
+        val = exp10 >= 0 ? val * POW10_TAB[exp10] : val / POW10_TAB[-exp10];
+        return neg ? -val : val;
+    }
+
+    // slow path: scale through the table in 10^22 chunks; once val hits
+    // inf or 0 the remaining factors no longer change it
+    int e = exp10;
+    while (e > 22) {
+        val *= 1e22;
+        e -= 22;
+    }
+    while (e < -22) {
+        val /= 1e22;
+        e += 22;
+    }
+    if (e > 0)
+        val *= POW10_TAB[e];
+    else if (e < 0)
+        val /= POW10_TAB[-e];
+    return neg ? -val : val;
+}
+
+// qsort: introsort — quicksort with a median-of-three pivot, an
+// insertion-sort cutoff so small partitions are finished while still
+// cache-resident, and a heapsort fallback when recursion degenerates
+
+#define SORT_INSERTION_CUTOFF 16
+
+static void sort_swap(char* a, char* b, size_t size) {
+    while (size-- > 0) {
+        char t = *a;
+        *a++ = *b;
+        *b++ = t;
+    }
+}
+
+static void insertion_sort(char* base, size_t n, size_t size, int (*compar)(const void*, const void*)) {
+    for (size_t i = 1; i < n; i++)
+        for (size_t j = i; j > 0 && compar(base + j * size, base + (j - 1) * size) < 0; j--)
+            sort_swap(base + j * size, base + (j - 1) * size, size);
+}
+
+static void heap_sift_down(char* base, size_t root, size_t n, size_t size, int (*compar)(const void*, const void*)) {
+    for (;;) {
+        size_t child = 2 * root + 1;
+        if (child >= n)
+            return;
+        if (child + 1 < n && compar(base + child * size, base + (child + 1) * size) < 0)
+            child++;
+        if (compar(base + root * size, base + child * size) >= 0)
+            return;
+        sort_swap(base + root * size, base + child * size, size);
+        root = child;
+    }
+}
+
+static void heap_sort(char* base, size_t n, size_t size, int (*compar)(const void*, const void*)) {
+    for (size_t i = n / 2; i > 0; i--)
+        heap_sift_down(base, i - 1, n, size, compar);
+    for (size_t i = n; i > 1; i--) {
+        sort_swap(base, base + (i - 1) * size, size);
+        heap_sift_down(base, 0, i - 1, size, compar);
+    }
+}
+
+static void intro_sort(char* base, size_t n, size_t size, int depth, int (*compar)(const void*, const void*)) {
+    while (n > SORT_INSERTION_CUTOFF) {
+        if (depth-- == 0) {
+            heap_sort(base, n, size, compar);
+            return;
+        }
+
+        // median-of-three: order first/mid/last, then tuck the median
+        // next to the end as the pivot (first and last double as
+        // sentinels for the scan below)
+        char* mid = base + (n / 2) * size;
+        char* last = base + (n - 1) * size;
+        if (compar(mid, base) < 0)
+            sort_swap(mid, base, size);
+        if (compar(last, mid) < 0) {
+            sort_swap(last, mid, size);
+            if (compar(mid, base) < 0)
+                sort_swap(mid, base, size);
+        }
+        char* pivot = last - size;
+        sort_swap(mid, pivot, size);
+
+        size_t i = 0;
+        size_t j = n - 2;
+        for (;;) {
+            while (compar(base + ++i * size, pivot) < 0);
+            while (compar(pivot, base + --j * size) < 0);
+            if (i >= j)
+                break;
+            sort_swap(base + i * size, base + j * size, size);
+        }
+        sort_swap(base + i * size, pivot, size);
+
+        // recurse into the smaller side, loop on the larger one to
+        // bound the stack depth
+        size_t left_n = i;
+        size_t right_n = n - i - 1;
+        if (left_n < right_n) {
+            intro_sort(base, left_n, size, depth, compar);
+            base += (i + 1) * size;
+            n = right_n;
+        } else {
+            intro_sort(base + (i + 1) * size, right_n, size, depth, compar);
+            n = left_n;
+        }
+    }
+    insertion_sort(base, n, size, compar);
+}
+
+void qsort(void* base, size_t nmemb, size_t size, int (*compar)(const void*, const void*)) {
+    if (nmemb < 2 || size == 0)
+        return;
+
+    // depth limit 2 * log2(n), past which quicksort is degenerating
+    int depth = 0;
+    for (size_t n = nmemb; n > 1; n >>= 1)
+        depth += 2;
+
+    intro_sort((char*)base, nmemb, size, depth, compar);
+}
+
+void* bsearch(const void* key, const void* base, size_t nmemb, size_t size,
+              int (*compar)(const void*, const void*)) {
+    size_t lo = 0;
+    size_t hi = nmemb;
+
+    while (lo < hi) {
+        size_t mid = lo + (hi - lo) / 2;
+        const char* elem = (const char*)base + mid * size;
+        int c = compar(key, elem);
+        if (c == 0)
+            return (void*)elem;
+        if (c < 0)
+            hi = mid;
+        else
+            lo = mid + 1;
+    }
+    return NULL;
+}
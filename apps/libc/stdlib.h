@@ -6,6 +6,38 @@
 #define EXIT_SUCCESS 0
 #define EXIT_FAILURE 1
 
+// bump allocator with O(1) bulk reset, for transient buffers
+typedef struct {
+    char* base;
+    size_t size;
+    size_t used;
+} arena;
+
+// heap statistics snapshot - all sizes count block headers too, so
+// in_use_bytes + free_bytes == sbrk_bytes
+typedef struct {
+    size_t in_use_bytes;   // allocated and not yet freed
+    size_t free_bytes;     // sitting on the free lists
+    size_t free_blocks;    // blocks across all free lists
+    size_t largest_free;   // largest single free block
+    size_t sbrk_bytes;     // obtained from sys_sbrk and not yet returned
+} malloc_stats_t;
+
+void malloc_stats(malloc_stats_t* st);
+
+// called for sampled allocations with the malloc call site and the
+// requested size; the hook must not allocate
+typedef void (*malloc_sample_fn)(void* caller, size_t size);
+
+// samples every interval-th allocation of at least min_size bytes;
+// fn == NULL disables sampling
+void malloc_set_sample_hook(malloc_sample_fn fn, size_t min_size, size_t interval);
+
+arena* arena_create(size_t size);
+void* arena_alloc(arena* a, size_t len);
+void arena_reset(arena* a);
+void arena_destroy(arena* a);
+
 int abs(int i);
 void* malloc(size_t len);
 int atoi(const char* str);
@@ -19,5 +51,9 @@ int rename(const char* old, const char* _new);
 char* getenv(const char* name);
 void abort(void);
 long strtol(const char* nptr, char** endptr, int base);
+double strtod(const char* nptr, char** endptr);
+void qsort(void* base, size_t nmemb, size_t size, int (*compar)(const void*, const void*));
+void* bsearch(const void* key, const void* base, size_t nmemb, size_t size,
+              int (*compar)(const void*, const void*));
 
 #endif
@@ -1,8 +1,21 @@
 #include "string.h"
 
+#include <stdint.h>
+
 #include "ctype.h"
 #include "stdlib.h"
 
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+// word-at-a-time helpers: plain byte loops move one byte per iteration,
+// which makes framebuffer-sized copies the bottleneck
+typedef uint64_t __attribute__((may_alias)) word_t;
+
+// a byte of the word is zero iff this is non-zero
+#define WORD_HAS_ZERO(w) (((w) - 0x0101010101010101UL) & ~(w) & 0x8080808080808080UL)
+
 int strcmp(const char* s1, const char* s2) {
     while (*s1 != '\0' && *s2 != '\0' && *s1 == *s2) {
         s1++;
@@ -12,11 +25,25 @@ int strcmp(const char* s1, const char* s2) {
 }
 
 size_t strlen(const char* str) {
-    size_t res = 0;
-    while (*str++) {
-        res++;
+    const char* p = str;
+
+    // scan bytewise up to word alignment
+    while (((uintptr_t)p & (sizeof(word_t) - 1)) != 0) {
+        if (*p == '\0')
+            return p - str;
+        p++;
     }
-    return res;
+
+    // scan a word at a time for the terminator
+    const word_t* w = (const word_t*)p;
+    while (!WORD_HAS_ZERO(*w))
+        w++;
+
+    p = (const char*)w;
+    while (*p)
+        p++;
+
+    return p - str;
 }
 
 int split(char* str, const char regex, char** buf, size_t buflen) {
@@ -41,6 +68,55 @@ int split(char* str, const char regex, char** buf, size_t buflen) {
     return len;
 }
 
+// in-place tokenizer: overwrites delimiters with NULs and collapses runs,
+// so tokenizing needs no heap allocation (unlike split, empty tokens are
+// dropped)
+int tokenize(char* str, const char delim, char** buf, size_t buflen) {
+    int len = 0;
+    char* p = str;
+
+    while (*p != '\0' && len < (int)buflen) {
+        while (*p == delim)
+            *p++ = '\0';
+
+        if (*p == '\0')
+            break;
+
+        buf[len++] = p;
+
+        while (*p != '\0' && *p != delim)
+            p++;
+    }
+
+    return len;
+}
+
+// join strings with a delimiter into a caller-provided buffer;
+// returns the result length, or -1 if it does not fit
+int join(char* dst, size_t dst_len, const char* strs[], int len, const char* delimiter) {
+    size_t delimiter_len = strlen(delimiter);
+    size_t k = 0;
+
+    for (int i = 0; i < len; i++) {
+        size_t s_len = strlen(strs[i]);
+        size_t need = s_len + (i < len - 1 ? delimiter_len : 0);
+
+        if (k + need + 1 > dst_len)
+            return -1;
+
+        memcpy(dst + k, strs[i], s_len);
+        k += s_len;
+
+        if (i < len - 1) {
+            memcpy(dst + k, delimiter, delimiter_len);
+            k += delimiter_len;
+        }
+    }
+
+    dst[k] = '\0';
+    return (int)k;
+}
+
 char* concatenate(const char* strs[], int len, const char* delimiter) {
     int total_len = 0;
     int delimiter_len = strlen(delimiter);
@@ -95,6 +171,16 @@ int memcmp(const void* s1, const void* s2, size_t n) {
     const unsigned char* p1 = (const unsigned char*)s1;
     const unsigned char* p2 = (const unsigned char*)s2;
 
+    // compare whole words while they match, byte-resolve the first mismatch
+    while (n >= sizeof(word_t)) {
+        if (*(const word_t*)p1 != *(const word_t*)p2)
+            break;
+
+        p1 += sizeof(word_t);
+        p2 += sizeof(word_t);
+        n -= sizeof(word_t);
+    }
+
     while (n-- > 0) {
         if (*p1 != *p2)
             return *p1 - *p2;
@@ -109,6 +195,22 @@ void* memcpy(void* dest, const void* src, size_t len) {
     char* d = (char*)dest;
     const char* s = (char*)src;
 
+#ifdef __SSE2__
+    while (len >= 16) {
+        _mm_storeu_si128((__m128i*)d, _mm_loadu_si128((const __m128i*)s));
+        d += 16;
+        s += 16;
+        len -= 16;
+    }
+#endif
+
+    while (len >= sizeof(word_t)) {
+        *(word_t*)d = *(const word_t*)s;
+        d += sizeof(word_t);
+        s += sizeof(word_t);
+        len -= sizeof(word_t);
+    }
+
     while (len--)
         *d++ = *s++;
 
@@ -117,6 +219,22 @@ void* memcpy(void* dest, const void* src, size_t len) {
 
 void* memset(void* dest, int val, size_t len) {
     unsigned char* ptr = (unsigned char*)dest;
+    word_t pattern = (unsigned char)val * 0x0101010101010101UL;
+
+#ifdef __SSE2__
+    __m128i v = _mm_set1_epi8((char)val);
+    while (len >= 16) {
+        _mm_storeu_si128((__m128i*)ptr, v);
+        ptr += 16;
+        len -= 16;
+    }
+#endif
+
+    while (len >= sizeof(word_t)) {
+        *(word_t*)ptr = pattern;
+        ptr += sizeof(word_t);
+        len -= sizeof(word_t);
+    }
 
     while (len-- > 0)
         *ptr++ = val;
@@ -257,24 +375,40 @@ char* strdup(const char* s) {
     return mem;
 }
 
+// Boyer-Moore-Horspool: skip by the bad-character rule so search cost
+// stays sublinear instead of haystack x needle
 char* strstr(const char* s1, const char* s2) {
-    size_t i;
-    int c = s2[0];
+    size_t needle_len = strlen(s2);
 
-    if (c == 0)
+    if (needle_len == 0)
         return (char*)s1;
 
-    for (; s1[0] != '\0'; s1++) {
-        if (s1[0] != c)
-            continue;
+    if (needle_len == 1)
+        return strchr(s1, s2[0]);
 
-        for (i = 1; s2[i] != 0; i++) {
-            if (s1[i] != s2[i])
-                break;
-        }
+    size_t hay_len = strlen(s1);
+    if (hay_len < needle_len)
+        return NULL;
+
+    unsigned char skip[256];
+    size_t max_skip = needle_len < 255 ? needle_len : 255;
+    for (int i = 0; i < 256; i++)
+        skip[i] = (unsigned char)max_skip;
+    for (size_t i = needle_len > 255 ? needle_len - 255 : 0; i < needle_len - 1; i++)
+        skip[(unsigned char)s2[i]] = (unsigned char)(needle_len - 1 - i);
+
+    // jump straight to the first candidate byte
+    const char* first = (const char*)memchr(s1, s2[0], hay_len - needle_len + 1);
+    if (first == NULL)
+        return NULL;
+
+    size_t pos = first - s1;
+    while (pos <= hay_len - needle_len) {
+        if (s1[pos + needle_len - 1] == s2[needle_len - 1] &&
+            memcmp(s1 + pos, s2, needle_len - 1) == 0)
+            return (char*)(s1 + pos);
 
-        if (s2[i] == '\0')
-            return (char*)s1;
+        pos += skip[(unsigned char)s1[pos + needle_len - 1]];
     }
 
     return NULL;
@@ -6,6 +6,8 @@
 int strcmp(const char* s1, const char* s2);
 size_t strlen(const char* str);
 int split(char* str, const char regex, char** buf, size_t buflen);
+int tokenize(char* str, const char delim, char** buf, size_t buflen);
+int join(char* dst, size_t dst_len, const char* strs[], int len, const char* delimiter);
 char* concatenate(const char* strs[], int len, const char* delimiter);
 void replace(char* src, const char target, const char replace);
 int is_ascii(const char c);
@@ -0,0 +1,18 @@
+#ifndef _SYS_DIRENT_H
+#define _SYS_DIRENT_H
+
+#include <stdint.h>
+
+#define DIRENT_TYPE_FILE 0
+#define DIRENT_TYPE_DIR 1
+#define DIRENT_NAME_MAX 63
+
+// fixed-size directory record streamed by sys_getdents
+typedef struct
+{
+    uint64_t size;
+    uint8_t type;
+    char name[DIRENT_NAME_MAX + 1];
+} dirent;
+
+#endif
@@ -0,0 +1,28 @@
+#ifndef _SYS_INPUTEV_H
+#define _SYS_INPUTEV_H
+
+#include <stdint.h>
+
+#define INPUT_EV_TYPE_KEY 0
+#define INPUT_EV_TYPE_MOUSE 1
+
+// key codes: printable keys carry their ASCII value, special keys use
+// the values below
+#define INPUT_KEY_UP 0x100
+#define INPUT_KEY_DOWN 0x101
+#define INPUT_KEY_LEFT 0x102
+#define INPUT_KEY_RIGHT 0x103
+
+// fixed-size input record delivered in bursts on an event queue fd
+// (see subscribe_component_input) - key events carry code/pressed,
+// mouse events carry the absolute pointer position and left button
+typedef struct
+{
+    uint8_t type;
+    uint8_t pressed;
+    uint16_t code;
+    int16_t x;
+    int16_t y;
+} input_event;
+
+#endif
@@ -0,0 +1,21 @@
+#ifndef _SYS_POLL_H
+#define _SYS_POLL_H
+
+#include <stddef.h>
+
+#define POLLIN 0x1
+#define POLLOUT 0x4
+#define POLLERR 0x8
+#define POLLNVAL 0x20
+
+// negative fd entries are skipped, like POSIX poll
+typedef struct {
+    int fd;
+    short events;
+    short revents;
+} pollfd;
+
+// timeout_ms < 0 waits forever, 0 returns after one readiness pass
+int poll(pollfd* fds, size_t nfds, int timeout_ms);
+
+#endif
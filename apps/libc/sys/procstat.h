@@ -0,0 +1,24 @@
+#ifndef _SYS_PROCSTAT_H
+#define _SYS_PROCSTAT_H
+
+#include <stdint.h>
+
+#include "types.h"
+
+#define PROC_NAME_LEN 32
+
+// per-task record of /proc/stat - the whole table is read in one sys_read
+// state: 'R' running, 'Q' ready, 'S' sleeping, 'X' exited
+// ppid is -1 for tasks without a parent
+typedef struct {
+    pid_t pid;
+    pid_t ppid;
+    char state;
+    char name[PROC_NAME_LEN];
+    uint64_t cpu_time_ms;
+    uint64_t ctx_switches;
+    uint64_t syscalls;
+    uint64_t heap_bytes;
+} proc_stat;
+
+#endif
@@ -0,0 +1,12 @@
+#ifndef _SYS_PROF_H
+#define _SYS_PROF_H
+
+#include <stdint.h>
+
+// one entry of the flat profiler histogram: timer samples that hit addr
+typedef struct {
+    uint64_t addr;
+    uint64_t count;
+} prof_sample;
+
+#endif
@@ -3,6 +3,8 @@
 
 #include <stdint.h>
 
+#include "uio.h"
+
 typedef uint16_t sa_family_t;
 
 struct sockaddr {
@@ -36,4 +38,47 @@ struct sockaddr_in6 {
     uint32_t sin6_scope_id;
 };
 
+// sys_setsockopt/sys_getsockopt levels
+#define SOL_SOCKET 1
+#define IPPROTO_TCP 6
+
+// SOL_SOCKET options (int-valued)
+#define SO_RCVBUF 1
+#define SO_SNDBUF 2
+
+// IPPROTO_TCP options (int-valued)
+#define TCP_NODELAY 1
+#define TCP_WINDOW 2 // read-only: currently advertised receive window
+
+// shared receive ring (sys_recvring): the kernel delivers each packet
+// payload straight into a mapped slot and the app consumes filled
+// descriptors, without a copy into a socket queue or a syscall per
+// packet. head and tail are free-running counters: the kernel bumps
+// head after filling a slot, the app bumps tail after consuming one.
+// packets that arrive while the ring is full are dropped (TCP peers
+// retransmit once slots free up). the header is followed by one
+// uint32_t payload length per slot, then slot_count data slots of
+// slot_size bytes each. for TCP sockets slot_size must be at least the
+// receive MSS (1460 bytes) so every in-order segment fits a slot. the
+// mapping stays valid for the life of the process
+typedef struct {
+    volatile uint32_t head; // written by the kernel
+    volatile uint32_t tail; // written by the app
+    uint32_t slot_size;
+    uint32_t slot_count;
+} recv_ring;
+
+#define RECV_RING_LEN(ring, idx) (((uint32_t*)((uint8_t*)(ring) + sizeof(recv_ring)))[idx])
+#define RECV_RING_SLOT(ring, idx) \
+    ((uint8_t*)(ring) + sizeof(recv_ring) + (ring)->slot_count * sizeof(uint32_t) + (idx) * (ring)->slot_size)
+
+// scatter-gather message for sys_sendmsg - msg_name points to a
+// sockaddr_in for UDP, or is NULL for a connected TCP socket
+struct msghdr {
+    void* msg_name;
+    size_t msg_namelen;
+    iovec* msg_iov;
+    size_t msg_iovlen;
+};
+
 #endif
@@ -0,0 +1,18 @@
+#ifndef _SYS_TIMEPAGE_H
+#define _SYS_TIMEPAGE_H
+
+#include <stdint.h>
+
+// shared read-only page published by the kernel timer tick and mapped
+// into a task with sys_timepage - seq is even while the other fields
+// are consistent, so retry the read when it changes in between
+typedef struct
+{
+    uint32_t seq;
+    uint32_t _reserved;
+    uint64_t uptime_ms;
+    uint64_t tsc_at_tick;
+    uint64_t tsc_freq;
+} time_page;
+
+#endif
@@ -0,0 +1,12 @@
+#ifndef _SYS_UIO_H
+#define _SYS_UIO_H
+
+#include <stddef.h>
+
+typedef struct
+{
+    void* iov_base;
+    size_t iov_len;
+} iovec;
+
+#endif
@@ -1,5 +1,6 @@
 #include "syscalls.h"
 
+#include "errno.h"
 #include "sys/socket.h"
 
 static uint64_t syscall(uint64_t syscall_number, uint64_t arg1, uint64_t arg2, uint64_t arg3, uint64_t arg4, uint64_t arg5, uint64_t arg6) {
@@ -52,6 +53,11 @@ int sys_stat(int fd, f_stat* buf) {
     return (int)syscall(SN_STAT, (uint64_t)fd, (uint64_t)buf, 0, 0, 0, 0);
 }
 
+// open+stat in one path lookup; returns the fd and fills buf
+int sys_openstat(const char* filepath, int flags, f_stat* buf) {
+    return (int)syscall(SN_OPENSTAT, (uint64_t)filepath, (uint64_t)flags, (uint64_t)buf, 0, 0, 0);
+}
+
 uint64_t sys_uptime(void) {
     return syscall(SN_UPTIME, 0, 0, 0, 0, 0, 0);
 }
@@ -60,6 +66,12 @@ pid_t sys_exec(const char* args, int flags, int pipefd[3]) {
     return (pid_t)syscall(SN_EXEC, (uint64_t)args, (uint64_t)flags, (uint64_t)pipefd, 0, 0, 0);
 }
 
+// exec with a NULL-terminated argv array; no flattening into one
+// string, and arguments may contain spaces
+pid_t sys_execv(char* const argv[], int flags, int pipefd[3]) {
+    return (pid_t)syscall(SN_EXECV, (uint64_t)argv, (uint64_t)flags, (uint64_t)pipefd, 0, 0, 0);
+}
+
 int sys_getcwd(char* buf, size_t buf_len) {
     return (int)syscall(SN_GETCWD, (uint64_t)buf, (uint64_t)buf_len, 0, 0, 0, 0);
 }
@@ -72,8 +84,40 @@ int sys_free(void* ptr) {
     return (int)syscall(SN_FREE, (uint64_t)ptr, 0, 0, 0, 0, 0);
 }
 
-int sys_wait(pid_t pid) {
-    return (int)syscall(SN_WAIT, (uint64_t)pid, 0, 0, 0, 0, 0);
+int sys_wait(pid_t pid, int flags) {
+    return (int)syscall(SN_WAIT, (uint64_t)pid, (uint64_t)flags, 0, 0, 0, 0);
+}
+
+pid_t sys_thread_create(void (*entry)(void*), void* arg) {
+    return (pid_t)syscall(SN_THREAD_CREATE, (uint64_t)entry, (uint64_t)arg, 0, 0, 0, 0);
+}
+
+int sys_thread_join(pid_t tid) {
+    return (int)syscall(SN_THREAD_JOIN, (uint64_t)tid, 0, 0, 0, 0, 0);
+}
+
+int sys_shm_create(size_t size) {
+    return (int)syscall(SN_SHM_CREATE, (uint64_t)size, 0, 0, 0, 0, 0);
+}
+
+// returns NULL if the segment does not exist
+void* sys_shm_map(int shm_id) {
+    return (void*)syscall(SN_SHM_MAP, (uint64_t)shm_id, 0, 0, 0, 0, 0);
+}
+
+int sys_prof_start(pid_t pid) {
+    return (int)syscall(SN_PROF_START, (uint64_t)pid, 0, 0, 0, 0, 0);
+}
+
+// buf_len counts entries; returns the number of entries written
+int sys_prof_stop(prof_sample* buf, size_t buf_len) {
+    return (int)syscall(SN_PROF_STOP, (uint64_t)buf, (uint64_t)buf_len, 0, 0, 0, 0);
+}
+
+// TTY_MODE_RAW: sys_read on stdin returns all buffered bytes at once
+// without echo; timeout_ms < 0 blocks, 0 polls, > 0 waits that long
+int sys_ttymode(int mode, int timeout_ms) {
+    return (int)syscall(SN_TTYMODE, (uint64_t)mode, (uint64_t)timeout_ms, 0, 0, 0, 0);
 }
 
 size_t sys_sbrksz(const void* target) {
@@ -104,16 +148,47 @@ int sys_sendto(int sockfd, const void* buf, size_t len, int flags, const struct
     return (int)syscall(SN_SENDTO, (uint64_t)sockfd, (uint64_t)buf, (uint64_t)len, (uint64_t)flags, (uint64_t)dest_addr, (uint64_t)addrlen);
 }
 
+// maps the kernel's would-block return (for SOCKET_TYPE_NONBLOCK
+// sockets) to the standard -1 with errno set to EAGAIN
+static int socket_ret(int ret) {
+    if (ret == -EAGAIN) {
+        errno = EAGAIN;
+        return -1;
+    }
+    return ret;
+}
+
 int sys_recvfrom(int sockfd, void* buf, size_t len, int flags, struct sockaddr* src_addr, size_t addrlen) {
-    return (int)syscall(SN_RECVFROM, (uint64_t)sockfd, (uint64_t)buf, (uint64_t)len, (uint64_t)flags, (uint64_t)src_addr, (uint64_t)addrlen);
+    return socket_ret((int)syscall(SN_RECVFROM, (uint64_t)sockfd, (uint64_t)buf, (uint64_t)len, (uint64_t)flags, (uint64_t)src_addr, (uint64_t)addrlen));
 }
 
 int sys_send(int sockfd, const void* buf, size_t len, int flags) {
     return (int)syscall(SN_SEND, (uint64_t)sockfd, (uint64_t)buf, (uint64_t)len, (uint64_t)flags, 0, 0);
 }
 
+// gathers msg->msg_iov in the kernel, so callers don't have to
+// assemble multi-part messages into one contiguous buffer first
+int sys_sendmsg(int sockfd, const struct msghdr* msg, int flags) {
+    return (int)syscall(SN_SENDMSG, (uint64_t)sockfd, (uint64_t)msg, (uint64_t)flags, 0, 0, 0);
+}
+
+int sys_setsockopt(int sockfd, int level, int optname, const void* optval, size_t optlen) {
+    return (int)syscall(SN_SETSOCKOPT, (uint64_t)sockfd, (uint64_t)level, (uint64_t)optname, (uint64_t)optval, (uint64_t)optlen, 0);
+}
+
+int sys_getsockopt(int sockfd, int level, int optname, void* optval, size_t* optlen) {
+    return (int)syscall(SN_GETSOCKOPT, (uint64_t)sockfd, (uint64_t)level, (uint64_t)optname, (uint64_t)optval, (uint64_t)optlen, 0);
+}
+
+// maps a shared receive ring for the socket and switches it to ring
+// delivery; returns the ring base, or NULL on error
+recv_ring* sys_recvring(int sockfd, uint32_t slot_size, uint32_t slot_count) {
+    uint64_t addr = syscall(SN_RECVRING, (uint64_t)sockfd, (uint64_t)slot_size, (uint64_t)slot_count, 0, 0, 0);
+    return addr == (uint64_t)-1 ? NULL : (recv_ring*)addr;
+}
+
 int sys_recv(int sockfd, void* buf, size_t len, int flags) {
-    return (int)syscall(SN_RECV, (uint64_t)sockfd, (uint64_t)buf, (uint64_t)len, (uint64_t)flags, 0, 0);
+    return socket_ret((int)syscall(SN_RECV, (uint64_t)sockfd, (uint64_t)buf, (uint64_t)len, (uint64_t)flags, 0, 0));
 }
 
 int sys_connect(int sockfd, const struct sockaddr* addr, size_t addrlen) {
@@ -125,7 +200,7 @@ int sys_listen(int sockfd, int backlog) {
 }
 
 int sys_accept(int sockfd, struct sockaddr* addr, size_t* addrlen) {
-    return (int)syscall(SN_ACCEPT, (uint64_t)sockfd, (uint64_t)addr, (uint64_t)addrlen, 0, 0, 0);
+    return socket_ret((int)syscall(SN_ACCEPT, (uint64_t)sockfd, (uint64_t)addr, (uint64_t)addrlen, 0, 0, 0));
 }
 
 int sys_pipe(int pipefd[2]) {
@@ -135,3 +210,51 @@ int sys_pipe(int pipefd[2]) {
 off_t sys_lseek(int fd, off_t offset, int whence) {
     return (off_t)syscall(SN_LSEEK, (uint64_t)fd, (uint64_t)offset, (uint64_t)whence, 0, 0, 0);
 }
+
+// positional read/write: the shared fd position is left untouched, so
+// tasks sharing an fd don't race on it
+int sys_pread(int fd, void* buf, size_t len, off_t offset) {
+    return (int)syscall(SN_PREAD, (uint64_t)fd, (uint64_t)buf, (uint64_t)len, (uint64_t)offset, 0, 0);
+}
+
+int sys_pwrite(int fd, const void* buf, size_t len, off_t offset) {
+    return (int)syscall(SN_PWRITE, (uint64_t)fd, (uint64_t)buf, (uint64_t)len, (uint64_t)offset, 0, 0);
+}
+
+int sys_readv(int fd, const iovec* iov, int iovcnt) {
+    return (int)syscall(SN_READV, (uint64_t)fd, (uint64_t)iov, (uint64_t)iovcnt, 0, 0, 0);
+}
+
+int sys_writev(int fd, const iovec* iov, int iovcnt) {
+    return (int)syscall(SN_WRITEV, (uint64_t)fd, (uint64_t)iov, (uint64_t)iovcnt, 0, 0, 0);
+}
+
+// the mapping is released with sys_free, like sbrk memory; returns the
+// mapping base, or NULL on error
+void* sys_mmap(int fd, off_t offset, size_t len, int prot) {
+    uint64_t addr = syscall(SN_MMAP, (uint64_t)fd, (uint64_t)offset, (uint64_t)len, (uint64_t)prot, 0, 0);
+    return addr == (uint64_t)-1 ? NULL : (void*)addr;
+}
+
+const time_page* sys_timepage(void) {
+    uint64_t addr = syscall(SN_TIMEPAGE, 0, 0, 0, 0, 0, 0);
+    return addr == (uint64_t)-1 ? NULL : (const time_page*)addr;
+}
+
+// copies up to len bytes from in_fd to out_fd inside the kernel,
+// returns the number of bytes copied
+int sys_copyfd(int out_fd, int in_fd, size_t len) {
+    return (int)syscall(SN_COPYFD, (uint64_t)out_fd, (uint64_t)in_fd, (uint64_t)len, 0, 0, 0);
+}
+
+// waits until one of the watched fds is ready, returns the number of
+// entries with non-zero revents (0 on timeout)
+int sys_poll(pollfd* fds, size_t nfds, int timeout_ms) {
+    return (int)syscall(SN_POLL, (uint64_t)fds, (uint64_t)nfds, (uint64_t)timeout_ms, 0, 0, 0);
+}
+
+// fills buf with directory records starting at *cursor and advances it,
+// returns the number of records written (0 when the listing is exhausted)
+int sys_getdents(const char* path, uint64_t* cursor, dirent* buf, size_t buf_len) {
+    return (int)syscall(SN_GETDENTS, (uint64_t)path, (uint64_t)cursor, (uint64_t)buf, (uint64_t)buf_len, 0, 0);
+}
@@ -5,9 +5,15 @@
 #include <stdint.h>
 
 #include "iomsg.h"
+#include "sys/dirent.h"
+#include "sys/poll.h"
+#include "sys/procstat.h"
+#include "sys/prof.h"
 #include "sys/socket.h"
 #include "sys/stat.h"
+#include "sys/timepage.h"
 #include "sys/types.h"
+#include "sys/uio.h"
 #include "sys/utsname.h"
 
 // syscall numbers
@@ -41,6 +47,32 @@
 #define SN_ACCEPT 27
 #define SN_PIPE 28
 #define SN_LSEEK 29
+#define SN_READV 30
+#define SN_WRITEV 31
+#define SN_MMAP 32
+#define SN_TIMEPAGE 33
+#define SN_GETDENTS 34
+#define SN_COPYFD 35
+#define SN_POLL 36
+#define SN_SENDMSG 37
+#define SN_SETSOCKOPT 38
+#define SN_GETSOCKOPT 39
+#define SN_RECVRING 40
+#define SN_PREAD 41
+#define SN_PWRITE 42
+#define SN_OPENSTAT 43
+#define SN_EXECV 44
+#define SN_THREAD_CREATE 45
+#define SN_THREAD_JOIN 46
+#define SN_SHM_CREATE 47
+#define SN_SHM_MAP 48
+#define SN_PROF_START 49
+#define SN_PROF_STOP 50
+#define SN_TTYMODE 51
+
+// tty input modes (sys_ttymode)
+#define TTY_MODE_CANONICAL 0
+#define TTY_MODE_RAW 1
 
 // defined file descriptor numbers
 #define FDN_STDIN 0
@@ -51,6 +83,17 @@
 #define OPEN_FLAG_NONE 0x0
 #define OPEN_FLAG_CREATE 0x1
 
+// sys_mmap prot flags
+#define PROT_READ 0x1
+#define PROT_WRITE 0x2
+
+// sys_wait flags
+#define WAIT_FLAG_NONE 0x0
+#define WAIT_FLAG_NOHANG 0x1
+
+// sys_wait(WAIT_FLAG_NOHANG) return value while the child is still running
+#define WAIT_STILL_RUNNING -2
+
 // sys_exec flags
 #define EXEC_FLAG_NONE 0x0
 #define EXEC_FLAG_DEBUG 0x1
@@ -62,6 +105,9 @@
 #define SOCKET_DOMAIN_AF_INET 1
 #define SOCKET_TYPE_SOCK_DGRAM 1
 #define SOCKET_TYPE_SOCK_STREAM 2
+// OR into the socket type: recv/accept return -1 with errno EAGAIN
+// instead of blocking
+#define SOCKET_TYPE_NONBLOCK 0x100
 #define SOCKET_PROTO_UDP 17
 
 int sys_read(int fd, void* buf, size_t buf_len);
@@ -73,12 +119,23 @@ void* sys_sbrk(size_t len);
 int sys_uname(utsname* buf);
 void sys_break(void);
 int sys_stat(int fd, f_stat* buf);
+int sys_openstat(const char* filepath, int flags, f_stat* buf);
 uint64_t sys_uptime(void);
 pid_t sys_exec(const char* args, int flags, int pipefd[3]);
+pid_t sys_execv(char* const argv[], int flags, int pipefd[3]);
 int sys_getcwd(char* buf, size_t buf_len);
 int sys_chdir(const char* path);
 int sys_free(void* ptr);
-int sys_wait(pid_t pid);
+int sys_wait(pid_t pid, int flags);
+pid_t sys_thread_create(void (*entry)(void*), void* arg);
+int sys_thread_join(pid_t tid);
+int sys_shm_create(size_t size);
+void* sys_shm_map(int shm_id);
+int sys_prof_start(pid_t pid);
+int sys_prof_stop(prof_sample* buf, size_t buf_len);
+int sys_ttymode(int mode, int timeout_ms);
+int sys_copyfd(int out_fd, int in_fd, size_t len);
+int sys_poll(pollfd* fds, size_t nfds, int timeout_ms);
 size_t sys_sbrksz(const void* target);
 pid_t sys_getpid(void);
 int sys_getenames(const char* path, char* buf, size_t buf_len);
@@ -88,11 +145,22 @@ int sys_bind(int sockfd, const struct sockaddr* addr, size_t addrlen);
 int sys_sendto(int sockfd, const void* buf, size_t len, int flags, const struct sockaddr* dest_addr, size_t addrlen);
 int sys_recvfrom(int sockfd, void* buf, size_t len, int flags, struct sockaddr* src_addr, size_t addrlen);
 int sys_send(int sockfd, const void* buf, size_t len, int flags);
+int sys_sendmsg(int sockfd, const struct msghdr* msg, int flags);
+int sys_setsockopt(int sockfd, int level, int optname, const void* optval, size_t optlen);
+int sys_getsockopt(int sockfd, int level, int optname, void* optval, size_t* optlen);
+recv_ring* sys_recvring(int sockfd, uint32_t slot_size, uint32_t slot_count);
 int sys_recv(int sockfd, void* buf, size_t len, int flags);
 int sys_connect(int sockfd, const struct sockaddr* addr, size_t addrlen);
 int sys_listen(int sockfd, int backlog);
 int sys_accept(int sockfd, struct sockaddr* addr, size_t* addrlen);
 int sys_pipe(int pipefd[2]);
 off_t sys_lseek(int fd, off_t offset, int whence);
+int sys_pread(int fd, void* buf, size_t len, off_t offset);
+int sys_pwrite(int fd, const void* buf, size_t len, off_t offset);
+int sys_readv(int fd, const iovec* iov, int iovcnt);
+int sys_writev(int fd, const iovec* iov, int iovcnt);
+void* sys_mmap(int fd, off_t offset, size_t len, int prot);
+const time_page* sys_timepage(void);
+int sys_getdents(const char* path, uint64_t* cursor, dirent* buf, size_t buf_len);
 
 #endif
@@ -4,14 +4,64 @@
 
 #include "syscalls.h"
 
+// time page mapped once per process, NULL until the first successful map
+static const time_page* tp = NULL;
+
+static uint64_t rdtsc(void) {
+    uint32_t lo, hi;
+    __asm__ volatile("rdtsc" : "=a"(lo), "=d"(hi));
+    return ((uint64_t)hi << 32) | lo;
+}
+
+static const time_page* timepage(void) {
+    if (tp == NULL) {
+        tp = sys_timepage();
+    }
+    return tp;
+}
+
+// nanoseconds since boot, read from the shared time page without a
+// syscall - the kernel publishes uptime and a TSC sample every tick,
+// and the TSC delta since that sample interpolates between ticks
+uint64_t uptime_ns(void) {
+    const time_page* page = timepage();
+    if (page == NULL) {
+        return sys_uptime() * 1000000ull;
+    }
+
+    for (;;) {
+        uint32_t seq = *(volatile const uint32_t*)&page->seq;
+        if (seq & 1) {
+            continue;
+        }
+
+        uint64_t ms = page->uptime_ms;
+        uint64_t tsc_at_tick = page->tsc_at_tick;
+        uint64_t tsc_freq = page->tsc_freq;
+
+        if (*(volatile const uint32_t*)&page->seq != seq) {
+            continue;
+        }
+
+        uint64_t ns = ms * 1000000ull;
+        if (tsc_freq != 0) {
+            ns += (rdtsc() - tsc_at_tick) * 1000000000ull / tsc_freq;
+        }
+        return ns;
+    }
+}
+
+// no RTC is wired up, so this is seconds since boot
 time_t time(time_t* t) {
-    printf("[DEBUG]time called\n");
-    return 0;
+    time_t sec = (time_t)(uptime_ns() / 1000000000ull);
+    if (t != NULL) {
+        *t = sec;
+    }
+    return sec;
 }
 
 clock_t clock(void) {
-    printf("[DEBUG]clock called\n");
-    return 0;
+    return (clock_t)(uptime_ns() / (1000000000ull / CLOCKS_PER_SEC));
 }
 
 double difftime(time_t time1, time_t time0) {
@@ -2,6 +2,7 @@
 #define _TIME_H
 
 #include <stddef.h>
+#include <stdint.h>
 
 typedef long time_t;
 
@@ -22,6 +23,7 @@ typedef long clock_t;
 
 time_t time(time_t* t);
 clock_t clock(void);
+uint64_t uptime_ns(void);
 double difftime(time_t time1, time_t time0);
 time_t mktime(struct tm* timeptr);
 size_t strftime(char* restrict s, size_t maxsize, const char* restrict format, const struct tm* restrict timeptr);
@@ -5,54 +5,70 @@
 #include "string.h"
 #include "syscalls.h"
 
-int remove_component(component_descriptor* cdesc) {
-    if (cdesc == NULL) {
-        return -1;
+// every message type is a small fixed-size struct, so requests and
+// replies live on the stack and descriptors come from a static pool -
+// the window IPC path never touches the allocator (DOOM calls it every
+// frame)
+#define CDESC_POOL_SIZE 16
+
+static component_descriptor cdesc_pool[CDESC_POOL_SIZE];
+static uint8_t cdesc_used[CDESC_POOL_SIZE];
+
+static component_descriptor* cdesc_acquire(void) {
+    for (int i = 0; i < CDESC_POOL_SIZE; i++) {
+        if (!cdesc_used[i]) {
+            cdesc_used[i] = 1;
+            return &cdesc_pool[i];
+        }
     }
 
-    void* msgbuf = malloc(sizeof(iomsg_remove_component));
-    if (msgbuf == NULL) {
-        return -1;
+    // pool exhausted - fall back to the allocator
+    return (component_descriptor*)malloc(sizeof(component_descriptor));
+}
+
+static void cdesc_release(component_descriptor* cdesc) {
+    if (cdesc >= cdesc_pool && cdesc < cdesc_pool + CDESC_POOL_SIZE) {
+        cdesc_used[cdesc - cdesc_pool] = 0;
+        return;
     }
 
-    iomsg_remove_component* msg = (iomsg_remove_component*)msgbuf;
-    msg->header.cmd_id = IOMSG_CMD_REMOVE_COMPONENT;
-    msg->header.payload_size = sizeof(int);
-    msg->layer_id = cdesc->layer_id;
+    free(cdesc);
+}
 
-    void* replymsgbuf = malloc(sizeof(iomsg_reply_remove_component));
-    if (replymsgbuf == NULL) {
-        free(msgbuf);
+int remove_component(component_descriptor* cdesc) {
+    if (cdesc == NULL) {
         return -1;
     }
 
-    iomsg_reply_remove_component* replymsg = (iomsg_reply_remove_component*)replymsgbuf;
-    if (sys_iomsg(msgbuf, replymsgbuf, sizeof(iomsg_reply_remove_component)) == -1) {
-        free(msgbuf);
-        free(replymsgbuf);
+    iomsg_remove_component msg;
+    iomsg_reply_remove_component replymsg;
+
+    msg.header.cmd_id = IOMSG_CMD_REMOVE_COMPONENT;
+    msg.header.payload_size = sizeof(int);
+    msg.layer_id = cdesc->layer_id;
+
+    if (sys_iomsg(&msg, &replymsg, sizeof(replymsg)) == -1) {
         return -1;
     }
 
-    if (replymsg->header.cmd_id != IOMSG_CMD_REMOVE_COMPONENT) {
-        free(msgbuf);
-        free(replymsgbuf);
+    if (replymsg.header.cmd_id != IOMSG_CMD_REMOVE_COMPONENT) {
         return -1;
     }
 
-    free(msgbuf);
-    free(replymsgbuf);
-    free(cdesc);
+    cdesc_release(cdesc);
     return 0;
 }
 
 component_descriptor* create_component_window(const char* title, size_t x_pos, size_t y_pos, size_t width, size_t height) {
     size_t title_len = strlen(title) + 1;
-    void* msgbuf = malloc(sizeof(iomsg_create_component_window) + title_len);
-    if (msgbuf == NULL) {
+    if (title_len > WINDOW_TITLE_MAX) {
         return NULL;
     }
 
+    char msgbuf[sizeof(iomsg_create_component_window) + WINDOW_TITLE_MAX] __attribute__((aligned(8)));
     iomsg_create_component_window* msg = (iomsg_create_component_window*)msgbuf;
+    iomsg_reply_create_component replymsg;
+
     msg->header.cmd_id = IOMSG_CMD_CREATE_COMPONENT_WINDOW;
     msg->header.payload_size = 8 * 4 + title_len;
     msg->x_pos = x_pos;
@@ -61,37 +77,23 @@ component_descriptor* create_component_window(const char* title, size_t x_pos, s
     msg->height = height;
     memcpy(msg->title, title, title_len);
 
-    void* replymsgbuf = malloc(sizeof(iomsg_reply_create_component));
-    if (replymsgbuf == NULL) {
-        free(msgbuf);
-        return NULL;
-    }
-
-    iomsg_reply_create_component* replymsg = (iomsg_reply_create_component*)replymsgbuf;
-
-    if (sys_iomsg(msgbuf, replymsgbuf, sizeof(iomsg_reply_create_component)) == -1) {
-        free(msgbuf);
-        free(replymsgbuf);
+    if (sys_iomsg(msg, &replymsg, sizeof(replymsg)) == -1) {
         return NULL;
     }
 
-    if (replymsg->header.cmd_id != IOMSG_CMD_CREATE_COMPONENT_WINDOW) {
-        free(msgbuf);
-        free(replymsgbuf);
+    if (replymsg.header.cmd_id != IOMSG_CMD_CREATE_COMPONENT_WINDOW) {
         return NULL;
     }
 
-    component_descriptor* cdesc = (component_descriptor*)malloc(sizeof(component_descriptor));
+    component_descriptor* cdesc = cdesc_acquire();
     if (cdesc == NULL) {
-        free(msgbuf);
-        free(replymsgbuf);
         return NULL;
     }
 
-    cdesc->layer_id = replymsg->layer_id;
-
-    free(msgbuf);
-    free(replymsgbuf);
+    cdesc->layer_id = replymsg.layer_id;
+    cdesc->framebufs[0] = NULL;
+    cdesc->framebufs[1] = NULL;
+    cdesc->front = 0;
     return cdesc;
 }
 
@@ -100,49 +102,142 @@ component_descriptor* create_component_image(component_descriptor* cdesc, size_t
         return NULL;
     }
 
-    void* msgbuf = malloc(sizeof(iomsg_create_component_image));
-    if (msgbuf == NULL) {
-        return NULL;
-    }
+    iomsg_create_component_image msg;
+    iomsg_reply_create_component replymsg;
 
-    iomsg_create_component_image* msg = (iomsg_create_component_image*)msgbuf;
-    msg->header.cmd_id = IOMSG_CMD_CREATE_COMPONENT_IMAGE;
-    msg->header.payload_size = sizeof(iomsg_create_component_image) - sizeof(iomsg_header);
-    msg->layer_id = cdesc->layer_id;
-    msg->image_width = image_width;
-    msg->image_height = image_height;
-    msg->pixel_format = pixel_format;
-    msg->framebuf = framebuf;
+    msg.header.cmd_id = IOMSG_CMD_CREATE_COMPONENT_IMAGE;
+    msg.header.payload_size = sizeof(iomsg_create_component_image) - sizeof(iomsg_header);
+    msg.layer_id = cdesc->layer_id;
+    msg.image_width = image_width;
+    msg.image_height = image_height;
+    msg.pixel_format = pixel_format;
+    msg.framebuf = framebuf;
 
-    void* replymsgbuf = malloc(sizeof(iomsg_reply_create_component));
-    if (replymsgbuf == NULL) {
-        free(msgbuf);
+    if (sys_iomsg(&msg, &replymsg, sizeof(replymsg)) == -1) {
         return NULL;
     }
 
-    iomsg_reply_create_component* replymsg = (iomsg_reply_create_component*)replymsgbuf;
+    if (replymsg.header.cmd_id != IOMSG_CMD_CREATE_COMPONENT_IMAGE) {
+        return NULL;
+    }
 
-    if (sys_iomsg(msgbuf, replymsgbuf, sizeof(iomsg_reply_create_component)) == -1) {
-        free(msgbuf);
-        free(replymsgbuf);
+    component_descriptor* new_cdesc = cdesc_acquire();
+    if (new_cdesc == NULL) {
         return NULL;
     }
 
-    if (replymsg->header.cmd_id != IOMSG_CMD_CREATE_COMPONENT_IMAGE) {
-        free(msgbuf);
-        free(replymsgbuf);
+    new_cdesc->layer_id = replymsg.layer_id;
+    new_cdesc->framebufs[0] = framebuf;
+    new_cdesc->framebufs[1] = NULL;
+    new_cdesc->front = 0;
+    return new_cdesc;
+}
+
+// double-buffered variant: the compositor starts out sampling framebuf0,
+// the app renders into component_backbuffer() and flips when the frame
+// is complete - no copies, no drawing into the sampled surface
+component_descriptor* create_component_image2(component_descriptor* cdesc, size_t image_width, size_t image_height, uint8_t pixel_format, const void* framebuf0, const void* framebuf1) {
+    if (framebuf0 == NULL || framebuf1 == NULL) {
         return NULL;
     }
 
-    component_descriptor* new_cdesc = (component_descriptor*)malloc(sizeof(component_descriptor));
+    component_descriptor* new_cdesc = create_component_image(cdesc, image_width, image_height, pixel_format, framebuf0);
     if (new_cdesc == NULL) {
-        free(msgbuf);
-        free(replymsgbuf);
         return NULL;
     }
-    new_cdesc->layer_id = replymsg->layer_id;
 
-    free(msgbuf);
-    free(replymsgbuf);
+    new_cdesc->framebufs[1] = framebuf1;
     return new_cdesc;
 }
+
+// the buffer the compositor is not sampling - the app's render target
+void* component_backbuffer(component_descriptor* cdesc) {
+    if (cdesc == NULL || cdesc->framebufs[1] == NULL) {
+        return NULL;
+    }
+
+    return (void*)cdesc->framebufs[cdesc->front ^ 1];
+}
+
+// atomically points the compositor at the back buffer; the old front
+// buffer becomes the next render target
+int flip_component_image(component_descriptor* cdesc) {
+    if (cdesc == NULL || cdesc->framebufs[1] == NULL) {
+        return -1;
+    }
+
+    iomsg_flip_component_image msg;
+    iomsg_reply_flip_component_image replymsg;
+
+    msg.header.cmd_id = IOMSG_CMD_FLIP_COMPONENT_IMAGE;
+    msg.header.payload_size = sizeof(iomsg_flip_component_image) - sizeof(iomsg_header);
+    msg.layer_id = cdesc->layer_id;
+    msg.framebuf = cdesc->framebufs[cdesc->front ^ 1];
+
+    if (sys_iomsg(&msg, &replymsg, sizeof(replymsg)) == -1) {
+        return -1;
+    }
+
+    if (replymsg.header.cmd_id != IOMSG_CMD_FLIP_COMPONENT_IMAGE) {
+        return -1;
+    }
+
+    cdesc->front ^= 1;
+    return 0;
+}
+
+// submits a damage rectangle for an image created with
+// create_component_image - the kernel recomposites only the flushed
+// region of the shared framebuf instead of the full surface every tick
+int flush_component_image(component_descriptor* cdesc, size_t x, size_t y, size_t width, size_t height) {
+    if (cdesc == NULL) {
+        return -1;
+    }
+
+    iomsg_flush_component_image msg;
+    iomsg_reply_flush_component_image replymsg;
+
+    msg.header.cmd_id = IOMSG_CMD_FLUSH_COMPONENT_IMAGE;
+    msg.header.payload_size = sizeof(iomsg_flush_component_image) - sizeof(iomsg_header);
+    msg.layer_id = cdesc->layer_id;
+    msg.x = x;
+    msg.y = y;
+    msg.width = width;
+    msg.height = height;
+
+    if (sys_iomsg(&msg, &replymsg, sizeof(replymsg)) == -1) {
+        return -1;
+    }
+
+    if (replymsg.header.cmd_id != IOMSG_CMD_FLUSH_COMPONENT_IMAGE) {
+        return -1;
+    }
+
+    return 0;
+}
+
+// subscribes the component's window to kernel input events and returns
+// an event queue fd - one blocking sys_read drains a burst of packed
+// input_event records (see sys/inputev.h)
+int subscribe_component_input(component_descriptor* cdesc) {
+    if (cdesc == NULL) {
+        return -1;
+    }
+
+    iomsg_subscribe_input msg;
+    iomsg_reply_subscribe_input replymsg;
+
+    msg.header.cmd_id = IOMSG_CMD_SUBSCRIBE_INPUT;
+    msg.header.payload_size = sizeof(int);
+    msg.layer_id = cdesc->layer_id;
+
+    if (sys_iomsg(&msg, &replymsg, sizeof(replymsg)) == -1) {
+        return -1;
+    }
+
+    if (replymsg.header.cmd_id != IOMSG_CMD_SUBSCRIBE_INPUT) {
+        return -1;
+    }
+
+    return replymsg.event_fd;
+}
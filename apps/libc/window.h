@@ -4,6 +4,8 @@
 #include <stddef.h>
 #include <stdint.h>
 
+#define WINDOW_TITLE_MAX 128
+
 #define PIXEL_FORMAT_RGB 0
 #define PIXEL_FORMAT_BGR 1
 #define PIXEL_FORMAT_BGRA 2
@@ -11,10 +13,19 @@
 typedef struct
 {
     int layer_id;
+    // double-buffered image components only: the two surfaces and which
+    // one the compositor currently samples
+    const void* framebufs[2];
+    int front;
 } component_descriptor;
 
 int remove_component(component_descriptor* cdesc);
 component_descriptor* create_component_window(const char* title, size_t x_pos, size_t y_pos, size_t width, size_t height);
 component_descriptor* create_component_image(component_descriptor* cdesc, size_t image_width, size_t image_height, uint8_t pixel_format, const void* framebuf);
+component_descriptor* create_component_image2(component_descriptor* cdesc, size_t image_width, size_t image_height, uint8_t pixel_format, const void* framebuf0, const void* framebuf1);
+void* component_backbuffer(component_descriptor* cdesc);
+int flip_component_image(component_descriptor* cdesc);
+int flush_component_image(component_descriptor* cdesc, size_t x, size_t y, size_t width, size_t height);
+int subscribe_component_input(component_descriptor* cdesc);
 
 #endif
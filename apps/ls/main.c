@@ -1,7 +1,15 @@
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
 #include <syscalls.h>
 
-static char cwdenames[1280] = {0};
+#define DENTS_BATCH 32
+
+static dirent dents[DENTS_BATCH];
+
+static int cmp_dirent(const void* a, const void* b) {
+    return strcmp(((const dirent*)a)->name, ((const dirent*)b)->name);
+}
 
 int main(int argc, char* argv[]) {
     char* path;
@@ -12,33 +20,39 @@ int main(int argc, char* argv[]) {
         path = ".";
     }
 
-    if (sys_getenames(path, cwdenames, sizeof(cwdenames)) == -1) {
-        printf("ls: failed to get entry names\n");
-        return -1;
-    }
-
-    char old_c = '\0';
-
-    for (int i = 0; i < (int)sizeof(cwdenames); i++) {
-        char c = cwdenames[i];
-
-        // end of name list
-        if (old_c == '\0' && c == '\0' && i > 0) {
-            break;
+    // collect everything first so the listing prints in name order
+    // instead of raw FAT order
+    dirent* all = NULL;
+    size_t total = 0;
+    uint64_t cursor = 0;
+    int count;
+
+    while ((count = sys_getdents(path, &cursor, dents, sizeof(dents))) > 0) {
+        dirent* grown = (dirent*)realloc(all, (total + (size_t)count) * sizeof(dirent));
+        if (grown == NULL) {
+            free(all);
+            printf("ls: out of memory\n");
+            return -1;
         }
+        all = grown;
+        memcpy(all + total, dents, (size_t)count * sizeof(dirent));
+        total += (size_t)count;
+    }
 
-        if (c == '\0') {
-            printf("  ");
-        } else {
-            printf("%c", c);
-        }
+    if (count == -1) {
+        free(all);
+        printf("ls: failed to get directory entries\n");
+        return -1;
+    }
 
-        old_c = cwdenames[i];
+    qsort(all, total, sizeof(dirent), cmp_dirent);
 
-        // clear
-        cwdenames[i] = '\0';
+    for (size_t i = 0; i < total; i++) {
+        printf("%s%s  ", all[i].name, all[i].type == DIRENT_TYPE_DIR ? "/" : "");
     }
+
     printf("\n");
 
+    free(all);
     return 0;
 }
@@ -0,0 +1,240 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <syscalls.h>
+
+#define MAX_SAMPLES 4096
+#define MAX_SYMBOLS 2048
+#define MAX_ARGS 32
+
+// minimal ELF64 structures, just enough to walk the symbol table
+typedef struct {
+    unsigned char e_ident[16];
+    uint16_t e_type;
+    uint16_t e_machine;
+    uint32_t e_version;
+    uint64_t e_entry;
+    uint64_t e_phoff;
+    uint64_t e_shoff;
+    uint32_t e_flags;
+    uint16_t e_ehsize;
+    uint16_t e_phentsize;
+    uint16_t e_phnum;
+    uint16_t e_shentsize;
+    uint16_t e_shnum;
+    uint16_t e_shstrndx;
+} elf64_ehdr;
+
+typedef struct {
+    uint32_t sh_name;
+    uint32_t sh_type;
+    uint64_t sh_flags;
+    uint64_t sh_addr;
+    uint64_t sh_offset;
+    uint64_t sh_size;
+    uint32_t sh_link;
+    uint32_t sh_info;
+    uint64_t sh_addralign;
+    uint64_t sh_entsize;
+} elf64_shdr;
+
+typedef struct {
+    uint32_t st_name;
+    unsigned char st_info;
+    unsigned char st_other;
+    uint16_t st_shndx;
+    uint64_t st_value;
+    uint64_t st_size;
+} elf64_sym;
+
+#define SHT_SYMTAB 2
+#define STT_FUNC 2
+
+typedef struct {
+    uint64_t addr;
+    uint64_t size;
+    const char* name;
+    uint64_t hits;
+} func_sym;
+
+static prof_sample samples[MAX_SAMPLES];
+static func_sym syms[MAX_SYMBOLS];
+static int sym_count;
+
+static char* read_whole_file(const char* path, size_t* len) {
+    f_stat stat;
+    int fd = sys_openstat(path, OPEN_FLAG_NONE, &stat);
+    if (fd < 0)
+        return NULL;
+
+    char* buf = (char*)malloc(stat.size);
+    if (buf == NULL) {
+        sys_close(fd);
+        return NULL;
+    }
+
+    size_t off = 0;
+    while (off < stat.size) {
+        int n = sys_read(fd, buf + off, stat.size - off);
+        if (n <= 0)
+            break;
+        off += n;
+    }
+    sys_close(fd);
+
+    if (off != stat.size) {
+        free(buf);
+        return NULL;
+    }
+
+    *len = off;
+    return buf;
+}
+
+static int cmp_sym_addr(const void* a, const void* b) {
+    uint64_t aa = ((const func_sym*)a)->addr;
+    uint64_t ba = ((const func_sym*)b)->addr;
+    return aa < ba ? -1 : aa > ba ? 1 : 0;
+}
+
+static int cmp_sym_hits(const void* a, const void* b) {
+    uint64_t ah = ((const func_sym*)a)->hits;
+    uint64_t bh = ((const func_sym*)b)->hits;
+    return ah < bh ? 1 : ah > bh ? -1 : 0;
+}
+
+// collect STT_FUNC symbols from .symtab, sorted by address
+static int load_symbols(const char* elf, size_t elf_len) {
+    if (elf_len < sizeof(elf64_ehdr))
+        return -1;
+
+    const elf64_ehdr* ehdr = (const elf64_ehdr*)elf;
+    if (ehdr->e_ident[0] != 0x7f || ehdr->e_ident[1] != 'E' || ehdr->e_ident[2] != 'L' || ehdr->e_ident[3] != 'F')
+        return -1;
+
+    if (ehdr->e_shoff + (size_t)ehdr->e_shnum * sizeof(elf64_shdr) > elf_len)
+        return -1;
+
+    const elf64_shdr* shdrs = (const elf64_shdr*)(elf + ehdr->e_shoff);
+    for (int i = 0; i < ehdr->e_shnum; i++) {
+        if (shdrs[i].sh_type != SHT_SYMTAB || shdrs[i].sh_link >= ehdr->e_shnum)
+            continue;
+
+        const elf64_shdr* strtab = &shdrs[shdrs[i].sh_link];
+        if (shdrs[i].sh_offset + shdrs[i].sh_size > elf_len || strtab->sh_offset + strtab->sh_size > elf_len)
+            continue;
+
+        const elf64_sym* sym = (const elf64_sym*)(elf + shdrs[i].sh_offset);
+        size_t count = shdrs[i].sh_size / sizeof(elf64_sym);
+        for (size_t j = 0; j < count && sym_count < MAX_SYMBOLS; j++) {
+            if ((sym[j].st_info & 0xf) != STT_FUNC || sym[j].st_value == 0 || sym[j].st_name >= strtab->sh_size)
+                continue;
+
+            syms[sym_count].addr = sym[j].st_value;
+            syms[sym_count].size = sym[j].st_size;
+            syms[sym_count].name = elf + strtab->sh_offset + sym[j].st_name;
+            syms[sym_count].hits = 0;
+            sym_count++;
+        }
+    }
+
+    qsort(syms, sym_count, sizeof(func_sym), cmp_sym_addr);
+    return sym_count > 0 ? 0 : -1;
+}
+
+// nearest symbol at or below addr; a symbol with size 0 covers up to
+// the next one
+static func_sym* resolve(uint64_t addr) {
+    int lo = 0, hi = sym_count - 1, best = -1;
+    while (lo <= hi) {
+        int mid = (lo + hi) / 2;
+        if (syms[mid].addr <= addr) {
+            best = mid;
+            lo = mid + 1;
+        } else {
+            hi = mid - 1;
+        }
+    }
+
+    if (best < 0)
+        return NULL;
+    if (syms[best].size != 0 && addr >= syms[best].addr + syms[best].size)
+        return NULL;
+
+    return &syms[best];
+}
+
+int main(int argc, char* argv[]) {
+    if (argc < 2 || argc > MAX_ARGS) {
+        printf("Usage: prof <elf path> [args...]\n");
+        return -1;
+    }
+
+    size_t elf_len;
+    char* elf = read_whole_file(argv[1], &elf_len);
+    if (elf == NULL) {
+        printf("prof: failed to read %s\n", argv[1]);
+        return -1;
+    }
+
+    if (load_symbols(elf, elf_len) < 0) {
+        printf("prof: no symbols in %s\n", argv[1]);
+        free(elf);
+        return -1;
+    }
+
+    char* run_argv[MAX_ARGS];
+    for (int i = 1; i < argc; i++)
+        run_argv[i - 1] = argv[i];
+    run_argv[argc - 1] = NULL;
+
+    pid_t pid = sys_execv(run_argv, EXEC_FLAG_NONE, EXEC_PIPE_NONE);
+    if (pid < 0) {
+        printf("prof: failed to execute %s\n", argv[1]);
+        free(elf);
+        return -1;
+    }
+
+    if (sys_prof_start(pid) < 0) {
+        printf("prof: profiler is busy\n");
+        sys_wait(pid, WAIT_FLAG_NONE);
+        free(elf);
+        return -1;
+    }
+
+    int exit_code = sys_wait(pid, WAIT_FLAG_NONE);
+    int n = sys_prof_stop(samples, MAX_SAMPLES);
+    if (n < 0) {
+        printf("prof: failed to read samples\n");
+        free(elf);
+        return -1;
+    }
+
+    uint64_t total = 0;
+    uint64_t unresolved = 0;
+    for (int i = 0; i < n; i++) {
+        total += samples[i].count;
+
+        func_sym* sym = resolve(samples[i].addr);
+        if (sym != NULL)
+            sym->hits += samples[i].count;
+        else
+            unresolved += samples[i].count;
+    }
+
+    printf("prof: %s exited with %d, %llu samples\n", argv[1], exit_code, total);
+    if (total == 0)
+        return 0;
+
+    qsort(syms, sym_count, sizeof(func_sym), cmp_sym_hits);
+    printf("  HITS   PCT  ADDR              NAME\n");
+    for (int i = 0; i < sym_count && syms[i].hits > 0; i++) {
+        printf("%6llu  %3llu%%  %016llx  %s\n", syms[i].hits, syms[i].hits * 100 / total, syms[i].addr,
+               syms[i].name);
+    }
+    if (unresolved > 0)
+        printf("%6llu  %3llu%%  ????????????????  ?\n", unresolved, unresolved * 100 / total);
+
+    free(elf);
+    return 0;
+}
@@ -1,3 +1,40 @@
+#include <stdio.h>
+#include <syscalls.h>
+
+#define MAX_TASKS 64
+
+// one read of /proc/stat returns the whole task table as binary records
+static int read_stats(proc_stat* stats, size_t max) {
+    int fd = sys_open("/proc/stat", OPEN_FLAG_NONE);
+    if (fd == -1) {
+        return -1;
+    }
+
+    int n = sys_read(fd, stats, max * sizeof(proc_stat));
+    sys_close(fd);
+
+    if (n < 0) {
+        return -1;
+    }
+
+    return n / (int)sizeof(proc_stat);
+}
+
 int main(int argc, char const* argv[]) {
+    static proc_stat stats[MAX_TASKS];
+
+    int count = read_stats(stats, MAX_TASKS);
+    if (count < 0) {
+        printf("ps: failed to read /proc/stat\n");
+        return -1;
+    }
+
+    printf("  PID   PPID  S   TIME(ms)  SYSCALLS     CTXSW   HEAP(kB)  NAME\n");
+
+    for (int i = 0; i < count; i++) {
+        proc_stat* s = &stats[i];
+        printf("%5d  %5d  %c  %9llu  %8llu  %8llu  %9llu  %s\n", s->pid, s->ppid, s->state, s->cpu_time_ms, s->syscalls, s->ctx_switches, s->heap_bytes / 1024, s->name);
+    }
+
     return 0;
 }
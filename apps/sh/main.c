@@ -6,6 +6,7 @@
 
 #define BUF_LEN 128
 #define HISTORY_MAX 16
+#define JOBS_MAX 8
 
 static char buf[BUF_LEN] = {0};
 static char* splitted_buf[BUF_LEN];
@@ -16,6 +17,43 @@ static char filepath_buf[BUF_LEN] = {0};
 static char history[HISTORY_MAX][BUF_LEN];
 static int hist_count = 0;
 
+// background job table - pid 0 marks a free slot
+typedef struct {
+    pid_t pid;
+    char cmd[BUF_LEN];
+} job_t;
+
+static job_t jobs[JOBS_MAX];
+
+static void job_add(pid_t pid, const char* cmd) {
+    for (int i = 0; i < JOBS_MAX; i++) {
+        if (jobs[i].pid != 0) continue;
+
+        jobs[i].pid = pid;
+        strncpy(jobs[i].cmd, cmd, BUF_LEN - 1);
+        jobs[i].cmd[BUF_LEN - 1] = '\0';
+        printf("sh: [%d] %d\n", i + 1, pid);
+        return;
+    }
+
+    // table full - reap synchronously so the child is not leaked
+    printf("sh: job table full, waiting for pid %d\n", pid);
+    sys_wait(pid, WAIT_FLAG_NONE);
+}
+
+// reap finished background jobs without blocking the prompt
+static void jobs_poll(void) {
+    for (int i = 0; i < JOBS_MAX; i++) {
+        if (jobs[i].pid == 0) continue;
+
+        int ret = sys_wait(jobs[i].pid, WAIT_FLAG_NOHANG);
+        if (ret == WAIT_STILL_RUNNING) continue;
+
+        printf("sh: [%d] done, exit code: %d: %s\n", i + 1, ret, jobs[i].cmd);
+        jobs[i].pid = 0;
+    }
+}
+
 static void history_push(const char* line) {
     if (strlen(line) == 0) return;
     if (hist_count > 0 && strcmp(history[(hist_count - 1) % HISTORY_MAX], line) == 0) return;
@@ -24,29 +62,54 @@ static void history_push(const char* line) {
     hist_count++;
 }
 
+// raw-mode input arrives in batches - one sys_read returns every
+// buffered byte, so a paste or a held arrow key costs one syscall
+// instead of one per byte
+static char input_batch[BUF_LEN];
+static int input_batch_len = 0;
+static int input_batch_pos = 0;
+
+static int sh_getc(char* out) {
+    if (input_batch_pos >= input_batch_len) {
+        int n = sys_read(0, input_batch, sizeof(input_batch));
+        if (n <= 0) return -1;
+        input_batch_len = n;
+        input_batch_pos = 0;
+    }
+
+    *out = input_batch[input_batch_pos++];
+    return 0;
+}
+
 static int sh_readline(char* dst, int dst_len) {
     int len = 0;
     int hist_pos = hist_count;
     char saved_line[BUF_LEN] = {0};
 
+    // raw mode: the kernel neither cooks lines nor echoes, so this
+    // editor does both itself
+    sys_ttymode(TTY_MODE_RAW, -1);
+
     while (1) {
         char c;
-        if (sys_read(0, &c, 1) == -1) return -1;
+        if (sh_getc(&c) == -1) goto fail;
 
         if (c == '\n') {
+            sys_write(1, "\n", 1);
             dst[len] = '\0';
             break;
         } else if (c == '\x08' || c == '\x7f') {
             if (len > 0) {
                 len--;
                 dst[len] = '\0';
+                sys_write(1, "\x08", 1);
             }
             continue;
         } else if (c == '\x1b') { /* escape sequence */
             char c2, c3;
-            if (sys_read(0, &c2, 1) == -1) return -1;
+            if (sh_getc(&c2) == -1) goto fail;
             if (c2 != '[') continue;
-            if (sys_read(0, &c3, 1) == -1) return -1;
+            if (sh_getc(&c3) == -1) goto fail;
             c = (c3 == 'A') ? '\x10' : (c3 == 'B') ? '\x0e'
                                                    : '\0';
             if (c == '\0') continue;
@@ -86,51 +149,67 @@ static int sh_readline(char* dst, int dst_len) {
             if (len < dst_len - 1) {
                 dst[len++] = c;
                 dst[len] = '\0';
+                sys_write(1, &c, 1);
             }
         }
     }
+
+    sys_ttymode(TTY_MODE_CANONICAL, 0);
     return 0;
+
+fail:
+    sys_ttymode(TTY_MODE_CANONICAL, 0);
+    return -1;
 }
 
-static int build_exec_args(const char* cmd_str, char* out, int out_len) {
-    while (*cmd_str == ' ') cmd_str++;
-    if (*cmd_str == '\0') return -1;
+// tokenize cmd_str in place into a NULL-terminated argv, prefixing the
+// command name with envpath when one is set
+static int build_exec_argv(char* cmd_str, char** argv, int argv_max, char* path_buf, int path_buf_len) {
+    int argc = tokenize(cmd_str, ' ', argv, argv_max - 1);
+    if (argc < 1)
+        return -1;
 
     if (strlen(envpath) > 0) {
-        // find end of command name (first space or end of string)
-        const char* name_end = cmd_str;
-        while (*name_end != ' ' && *name_end != '\0') name_end++;
-
-        // copy command name to temp buffer to avoid %.*s
-        char name_buf[BUF_LEN] = {0};
-        int name_len = name_end - cmd_str;
-        strncpy(name_buf, cmd_str, name_len);
-
-        if (*name_end == '\0') {
-            snprintf(out, out_len, "%s/%s", envpath, name_buf);
-        } else {
-            // name_end points to ' ' followed by args
-            snprintf(out, out_len, "%s/%s%s", envpath, name_buf, name_end);
-        }
-    } else {
-        strncpy(out, cmd_str, out_len - 1);
-        out[out_len - 1] = '\0';
+        snprintf(path_buf, path_buf_len, "%s/%s", envpath, argv[0]);
+        argv[0] = path_buf;
     }
-    return 0;
+
+    argv[argc] = NULL;
+    return argc;
 }
 
 void exec_cmd(char* cmd) {
+    // trailing '&' runs the command as a background job
+    int background = 0;
+    int cmd_len = strlen(cmd);
+    while (cmd_len > 0 && cmd[cmd_len - 1] == ' ') cmd[--cmd_len] = '\0';
+    if (cmd_len > 0 && cmd[cmd_len - 1] == '&') {
+        background = 1;
+        cmd[--cmd_len] = '\0';
+        while (cmd_len > 0 && cmd[cmd_len - 1] == ' ') cmd[--cmd_len] = '\0';
+    }
+    if (cmd_len == 0) {
+        return;
+    }
+
+    // keep a copy for the job table before tokenize mangles the line
+    static char job_cmd[BUF_LEN];
+    strncpy(job_cmd, cmd, BUF_LEN - 1);
+    job_cmd[BUF_LEN - 1] = '\0';
+
     char* pipe_pos = strchr(cmd, '|');
     if (pipe_pos != NULL) {
         *pipe_pos = '\0';
         char* left = cmd;
         char* right = pipe_pos + 1;
 
-        static char left_args[BUF_LEN];
-        static char right_args[BUF_LEN];
+        static char* left_argv[BUF_LEN];
+        static char* right_argv[BUF_LEN];
+        static char left_path[BUF_LEN];
+        static char right_path[BUF_LEN];
 
-        if (build_exec_args(left, left_args, BUF_LEN) < 0 ||
-            build_exec_args(right, right_args, BUF_LEN) < 0) {
+        if (build_exec_argv(left, left_argv, BUF_LEN, left_path, BUF_LEN) < 0 ||
+            build_exec_argv(right, right_argv, BUF_LEN, right_path, BUF_LEN) < 0) {
             printf("sh: pipe: invalid command\n");
             return;
         }
@@ -141,29 +220,31 @@ void exec_cmd(char* cmd) {
             return;
         }
 
-        pid_t pid1 = sys_exec(left_args, EXEC_FLAG_NONE, (int[]){-1, pipefd[1], -1});
-        pid_t pid2 = sys_exec(right_args, EXEC_FLAG_NONE, (int[]){pipefd[0], -1, -1});
+        pid_t pid1 = sys_execv(left_argv, EXEC_FLAG_NONE, (int[]){-1, pipefd[1], -1});
+        pid_t pid2 = sys_execv(right_argv, EXEC_FLAG_NONE, (int[]){pipefd[0], -1, -1});
 
         if (pid1 < 0 || pid2 < 0) {
             printf("sh: pipe: exec failed\n");
             return;
         }
 
-        sys_wait(pid1);
-        sys_wait(pid2);
+        if (background) {
+            job_add(pid1, job_cmd);
+            job_add(pid2, job_cmd);
+            return;
+        }
+
+        sys_wait(pid1, WAIT_FLAG_NONE);
+        sys_wait(pid2, WAIT_FLAG_NONE);
         return;
     }
 
-    int cmdargs_len = split(cmd, ' ', splitted_buf, BUF_LEN);
+    int cmdargs_len = tokenize(cmd, ' ', splitted_buf, BUF_LEN - 1);
 
     if (cmdargs_len < 1) {
         return;
     }
 
-    if (strlen(splitted_buf[0]) == 0) {
-        return;
-    }
-
     if (strcmp(splitted_buf[0], "help") == 0) {
         printf("sh: Built-in commands:\n");
         printf("  help\n");
@@ -172,6 +253,8 @@ void exec_cmd(char* cmd) {
         printf("  exec\n");
         printf("  window\n");
         printf("  clear\n");
+        printf("  jobs\n");
+        printf("  <COMMAND> & runs in the background\n");
 
         if (strlen(envpath) > 0) {
             printf("sh: envpath available\n");
@@ -188,24 +271,30 @@ void exec_cmd(char* cmd) {
             return;
         }
 
-        char* args = splitted_buf[1];
-        if (cmdargs_len > 2) {
-            args = concatenate((const char**)(splitted_buf + 1), cmdargs_len - 1, " ");
-
-            if (args == NULL) {
-                printf("sh: exec: failed to concatenate arguments\n");
-                return;
-            }
-        }
-
-        pid_t pid = sys_exec(args, EXEC_FLAG_DEBUG, EXEC_PIPE_NONE);
+        splitted_buf[cmdargs_len] = NULL;
+        pid_t pid = sys_execv(splitted_buf + 1, EXEC_FLAG_DEBUG, EXEC_PIPE_NONE);
         if (pid == -1) {
             printf("sh: exec: failed\n");
             return;
         }
 
-        int exit_code = sys_wait(pid);
+        if (background) {
+            job_add(pid, job_cmd);
+            return;
+        }
+
+        int exit_code = sys_wait(pid, WAIT_FLAG_NONE);
         printf("sh: exit code: %d\n", exit_code);
+    } else if (strcmp(splitted_buf[0], "jobs") == 0) {
+        int running = 0;
+        for (int i = 0; i < JOBS_MAX; i++) {
+            if (jobs[i].pid == 0) continue;
+            printf("sh: [%d] running, pid %d: %s\n", i + 1, jobs[i].pid, jobs[i].cmd);
+            running++;
+        }
+        if (running == 0) {
+            printf("sh: jobs: no background jobs\n");
+        }
     } else if (strcmp(splitted_buf[0], "window") == 0) {
         component_descriptor* cdesc = create_component_window("test window", 200, 50, 300, 200);
         if (cdesc == NULL) {
@@ -220,23 +309,20 @@ void exec_cmd(char* cmd) {
     else if (strlen(envpath) > 0) {
         snprintf(filepath_buf, sizeof(filepath_buf), "%s/%s", envpath, splitted_buf[0]);
         splitted_buf[0] = filepath_buf;
-        char* args = splitted_buf[0];
-        if (cmdargs_len > 1) {
-            args = concatenate((const char**)splitted_buf, cmdargs_len, " ");
+        splitted_buf[cmdargs_len] = NULL;
 
-            if (args == NULL) {
-                printf("sh: exec: failed to concatenate arguments\n");
-                return;
-            }
-        }
-
-        pid_t pid = sys_exec(args, EXEC_FLAG_NONE, EXEC_PIPE_NONE);
+        pid_t pid = sys_execv(splitted_buf, EXEC_FLAG_NONE, EXEC_PIPE_NONE);
         if (pid == -1) {
             printf("sh: exec: failed\n");
             return;
         }
 
-        int exit_code = sys_wait(pid);
+        if (background) {
+            job_add(pid, job_cmd);
+            return;
+        }
+
+        int exit_code = sys_wait(pid, WAIT_FLAG_NONE);
         printf("sh: exit code: %d\n", exit_code);
     }
     // unreachable
@@ -254,6 +340,8 @@ int main(int argc, char const* argv[]) {
     }
 
     while (1) {
+        jobs_poll();
+
         getcwd_ret = sys_getcwd(cwd_path, sizeof(cwd_path));
         printf("\n\e[34m[%s]\e[m$ ", getcwd_ret == -1 ? "UNKNOWN" : cwd_path);
 
@@ -1,7 +1,23 @@
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 #include <sys/socket.h>
 #include <syscalls.h>
+#include <time.h>
+
+// network performance modes print one CSV record per measurement:
+//   netperf,<name>,bytes=N,total_ns=N,mb_per_s=N
+//   netperf,<name>,ops=N,total_ns=N,ns_per_op=N
+// the peer is the QEMU host side at 192.168.100.1 (UDP echo on :1234,
+// TCP sink on :12345)
+
+#define PEER_ADDR ((192 << 24) | (168 << 16) | (100 << 8) | 1)
+#define TCP_BW_TOTAL (4 * 1024 * 1024)
+#define UDP_RATE_PKTS 10000
+#define UDP_RATE_PKT_LEN 64
+#define PINGPONG_ROUNDS 100
+
+static uint8_t net_buf[65536];
 
 int test_udp() {
     int sockfd = sys_socket(SOCKET_DOMAIN_AF_INET, SOCKET_TYPE_SOCK_DGRAM, SOCKET_PROTO_UDP);
@@ -207,8 +223,158 @@ int test_pipe() {
     return 0;
 }
 
+// bulk TCP send of TCP_BW_TOTAL bytes with the given buffer size
+static int test_tcp_bw(size_t buf_len) {
+    int sockfd = sys_socket(SOCKET_DOMAIN_AF_INET, SOCKET_TYPE_SOCK_STREAM, 0);
+    if (sockfd < 0) {
+        printf("netperf: tcp_bw: failed to create socket\n");
+        return -1;
+    }
+
+    struct sockaddr_in dest_addr;
+    memset(&dest_addr, 0, sizeof(dest_addr));
+    dest_addr.sin_family = SOCKET_DOMAIN_AF_INET;
+    dest_addr.sin_port = 12345;
+    dest_addr.sin_addr.s_addr = PEER_ADDR;
+
+    if (sys_connect(sockfd, (struct sockaddr*)&dest_addr, sizeof(dest_addr)) < 0) {
+        printf("netperf: tcp_bw: failed to connect\n");
+        sys_close(sockfd);
+        return -1;
+    }
+
+    uint64_t sent_total = 0;
+    uint64_t start = uptime_ns();
+    while (sent_total < TCP_BW_TOTAL) {
+        int sent = sys_send(sockfd, net_buf, buf_len, 0);
+        if (sent < 0) {
+            printf("netperf: tcp_bw: failed to send\n");
+            sys_close(sockfd);
+            return -1;
+        }
+        sent_total += sent;
+    }
+    uint64_t ns = uptime_ns() - start;
+
+    char name[32];
+    snprintf(name, sizeof(name), "tcp_bw_%d", (int)buf_len);
+    printf("netperf,%s,bytes=%llu,total_ns=%llu,mb_per_s=%llu\n", name, sent_total, ns,
+           ns ? sent_total * 1000ull / ns : 0);
+
+    sys_close(sockfd);
+    return 0;
+}
+
+// packet rate of back-to-back small UDP datagrams
+static int test_udp_rate(void) {
+    int sockfd = sys_socket(SOCKET_DOMAIN_AF_INET, SOCKET_TYPE_SOCK_DGRAM, SOCKET_PROTO_UDP);
+    if (sockfd < 0) {
+        printf("netperf: udp_rate: failed to create socket\n");
+        return -1;
+    }
+
+    struct sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = SOCKET_DOMAIN_AF_INET;
+    addr.sin_port = 0;  // auto-assign
+    addr.sin_addr.s_addr = 0;
+
+    if (sys_bind(sockfd, (struct sockaddr*)&addr, sizeof(addr)) < 0) {
+        printf("netperf: udp_rate: failed to bind\n");
+        return -1;
+    }
+
+    struct sockaddr_in dest_addr;
+    memset(&dest_addr, 0, sizeof(dest_addr));
+    dest_addr.sin_family = SOCKET_DOMAIN_AF_INET;
+    dest_addr.sin_port = 1234;
+    dest_addr.sin_addr.s_addr = PEER_ADDR;
+
+    uint64_t start = uptime_ns();
+    for (int i = 0; i < UDP_RATE_PKTS; i++) {
+        if (sys_sendto(sockfd, net_buf, UDP_RATE_PKT_LEN, 0,
+                       (struct sockaddr*)&dest_addr, sizeof(dest_addr)) < 0) {
+            printf("netperf: udp_rate: failed to sendto\n");
+            return -1;
+        }
+    }
+    uint64_t ns = uptime_ns() - start;
+
+    printf("netperf,udp_rate,ops=%d,total_ns=%llu,ns_per_op=%llu\n", UDP_RATE_PKTS, ns,
+           ns / UDP_RATE_PKTS);
+    return 0;
+}
+
+// round-trip latency against the host UDP echo server
+static int test_pingpong(void) {
+    int sockfd = sys_socket(SOCKET_DOMAIN_AF_INET, SOCKET_TYPE_SOCK_DGRAM, SOCKET_PROTO_UDP);
+    if (sockfd < 0) {
+        printf("netperf: pingpong: failed to create socket\n");
+        return -1;
+    }
+
+    struct sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = SOCKET_DOMAIN_AF_INET;
+    addr.sin_port = 0;  // auto-assign
+    addr.sin_addr.s_addr = 0;
+
+    if (sys_bind(sockfd, (struct sockaddr*)&addr, sizeof(addr)) < 0) {
+        printf("netperf: pingpong: failed to bind\n");
+        return -1;
+    }
+
+    struct sockaddr_in dest_addr;
+    memset(&dest_addr, 0, sizeof(dest_addr));
+    dest_addr.sin_family = SOCKET_DOMAIN_AF_INET;
+    dest_addr.sin_port = 1234;
+    dest_addr.sin_addr.s_addr = PEER_ADDR;
+
+    struct sockaddr_in src_addr;
+    memset(&src_addr, 0, sizeof(src_addr));
+
+    uint64_t start = uptime_ns();
+    for (int i = 0; i < PINGPONG_ROUNDS; i++) {
+        if (sys_sendto(sockfd, net_buf, UDP_RATE_PKT_LEN, 0,
+                       (struct sockaddr*)&dest_addr, sizeof(dest_addr)) < 0) {
+            printf("netperf: pingpong: failed to sendto\n");
+            return -1;
+        }
+
+        int recv_len = 0;
+        while (recv_len <= 0) {
+            recv_len = sys_recvfrom(sockfd, net_buf, sizeof(net_buf), 0,
+                                    (struct sockaddr*)&src_addr, sizeof(src_addr));
+        }
+    }
+    uint64_t ns = uptime_ns() - start;
+
+    printf("netperf,pingpong,ops=%d,total_ns=%llu,ns_per_op=%llu\n", PINGPONG_ROUNDS, ns,
+           ns / PINGPONG_ROUNDS);
+    return 0;
+}
+
 int main(int argc, const char* argv[]) {
-    // return test_tcp_server();
-    // return test_tcp_client();
+    if (argc > 1) {
+        if (strcmp(argv[1], "udp") == 0) return test_udp();
+        if (strcmp(argv[1], "tcp-server") == 0) return test_tcp_server();
+        if (strcmp(argv[1], "tcp-client") == 0) return test_tcp_client();
+        if (strcmp(argv[1], "pipe") == 0) return test_pipe();
+        if (strcmp(argv[1], "udp-rate") == 0) return test_udp_rate();
+        if (strcmp(argv[1], "pingpong") == 0) return test_pingpong();
+        if (strcmp(argv[1], "tcp-bw") == 0) {
+            // sweep buffer sizes to expose per-call overhead
+            int ret = 0;
+            ret |= test_tcp_bw(1024);
+            ret |= test_tcp_bw(4096);
+            ret |= test_tcp_bw(16384);
+            ret |= test_tcp_bw(65536);
+            return ret;
+        }
+
+        printf("test: modes: udp tcp-server tcp-client pipe udp-rate pingpong tcp-bw\n");
+        return -1;
+    }
+
     return test_pipe();
 }
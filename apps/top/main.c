@@ -0,0 +1,101 @@
+#include <stdio.h>
+#include <string.h>
+#include <syscalls.h>
+
+#define MAX_TASKS 64
+#define REFRESH_MS 1000
+
+static proc_stat cur[MAX_TASKS];
+static proc_stat prev[MAX_TASKS];
+
+// one read of /proc/stat returns the whole task table as binary records
+static int read_stats(proc_stat* stats, size_t max) {
+    int fd = sys_open("/proc/stat", OPEN_FLAG_NONE);
+    if (fd == -1) {
+        return -1;
+    }
+
+    int n = sys_read(fd, stats, max * sizeof(proc_stat));
+    sys_close(fd);
+
+    if (n < 0) {
+        return -1;
+    }
+
+    return n / (int)sizeof(proc_stat);
+}
+
+static uint64_t cpu_delta(const proc_stat* s, int prev_count) {
+    for (int i = 0; i < prev_count; i++) {
+        if (prev[i].pid == s->pid) {
+            return s->cpu_time_ms - prev[i].cpu_time_ms;
+        }
+    }
+
+    // task appeared after the previous snapshot
+    return s->cpu_time_ms;
+}
+
+int main(int argc, char const* argv[]) {
+    int prev_count = 0;
+    uint64_t prev_uptime_ms = sys_uptime();
+
+    for (;;) {
+        int count = read_stats(cur, MAX_TASKS);
+        if (count < 0) {
+            printf("top: failed to read /proc/stat\n");
+            return -1;
+        }
+
+        uint64_t uptime_ms = sys_uptime();
+        uint64_t elapsed_ms = uptime_ms - prev_uptime_ms;
+        if (elapsed_ms == 0) {
+            elapsed_ms = 1;
+        }
+
+        uint64_t deltas[MAX_TASKS];
+        int order[MAX_TASKS];
+        for (int i = 0; i < count; i++) {
+            deltas[i] = cpu_delta(&cur[i], prev_count);
+            order[i] = i;
+        }
+
+        // sort indices by cpu delta, busiest first
+        for (int i = 1; i < count; i++) {
+            int idx = order[i];
+            int j = i - 1;
+            while (j >= 0 && deltas[order[j]] < deltas[idx]) {
+                order[j + 1] = order[j];
+                j--;
+            }
+            order[j + 1] = idx;
+        }
+
+        printf("\x1b[2J\x1b[H");
+        printf("top - uptime %llu.%02llus, %d tasks (q to quit)\n", uptime_ms / 1000, (uptime_ms % 1000) / 10, count);
+        printf("  PID  S  CPU%%   TIME(ms)  SYSCALLS   HEAP(kB)  NAME\n");
+
+        for (int i = 0; i < count; i++) {
+            proc_stat* s = &cur[order[i]];
+            uint64_t percent = deltas[order[i]] * 100 / elapsed_ms;
+            printf("%5d  %c  %3llu%%  %9llu  %8llu  %9llu  %s\n", s->pid, s->state, percent, s->cpu_time_ms, s->syscalls, s->heap_bytes / 1024, s->name);
+        }
+
+        memcpy(prev, cur, count * sizeof(proc_stat));
+        prev_count = count;
+        prev_uptime_ms = uptime_ms;
+
+        pollfd pfd = {FDN_STDIN, POLLIN, 0};
+        if (sys_poll(&pfd, 1, REFRESH_MS) > 0 && (pfd.revents & POLLIN)) {
+            char c = 0;
+            sys_read(FDN_STDIN, &c, 1);
+            if (c == 'q' || c == 0x3) {
+                break;
+            }
+        }
+    }
+
+    printf("\n");
+
+    return 0;
+}
@@ -364,11 +364,20 @@ extern "x86-interrupt" fn page_fault_handler(
     error_code: PageFaultErrorCode,
 ) {
     let accessed_virt_addr = Cr2::read().raw().into();
+
+    // lazily loaded ELF pages are mapped on first touch - from user
+    // code, or from the kernel dereferencing an untouched user buffer
+    // during a syscall
+    if task::scheduler::demand_page(accessed_virt_addr).is_ok() {
+        return;
+    }
+
     let is_user = error_code.user_mode();
     let pml4_table = if !is_user {
         unsafe { &*paging::kernel_page_table() }
     } else {
-        todo!()
+        // user faults run on the faulting task's page table
+        unsafe { &*(Cr3::read().raw() as *const paging::PageTable) }
     };
     let pte = unsafe { paging::lookup_pte(pml4_table, accessed_virt_addr) };
 
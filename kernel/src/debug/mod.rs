@@ -9,6 +9,7 @@ use alloc::string::ToString;
 
 pub mod dwarf;
 pub mod logger;
+pub mod profiler;
 pub mod qemu;
 
 #[derive(Debug, Clone, Copy, PartialEq, Eq)]
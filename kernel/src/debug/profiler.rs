@@ -0,0 +1,78 @@
+use crate::{
+    error::{Error, Result},
+    sync::mutex::Mutex,
+    task::TaskId,
+};
+use alloc::{collections::btree_map::BTreeMap, vec::Vec};
+
+// flat sampling profiler: every local APIC timer interrupt that lands in
+// user code of the target task records the interrupted rip, and the prof
+// tool resolves the resulting address histogram against the target's ELF
+// symbols
+
+// distinct sampled addresses kept before new ones are dropped
+const MAX_SAMPLE_ADDRS: usize = 4096;
+
+#[derive(Debug)]
+struct Profiler {
+    target: Option<TaskId>,
+    hits: BTreeMap<u64, u64>,
+    dropped: u64,
+}
+
+static PROFILER: Mutex<Profiler> = Mutex::new(Profiler {
+    target: None,
+    hits: BTreeMap::new(),
+    dropped: 0,
+});
+
+// start sampling the given task, clearing any previous histogram
+pub fn start(target: TaskId) -> Result<()> {
+    let mut prof = PROFILER.try_lock()?;
+
+    if prof.target.is_some() {
+        return Err(Error::AlreadyExists.into());
+    }
+
+    prof.target = Some(target);
+    prof.hits.clear();
+    prof.dropped = 0;
+
+    Ok(())
+}
+
+// stop sampling and hand out the (address, hit count) histogram
+pub fn stop() -> Result<Vec<(u64, u64)>> {
+    let mut prof = PROFILER.try_lock()?;
+
+    if prof.target.is_none() {
+        return Err(Error::NotInitialized.with_context("profiler"));
+    }
+
+    prof.target = None;
+    if prof.dropped > 0 {
+        crate::kwarn!("profiler: {} samples dropped", prof.dropped);
+    }
+
+    Ok(core::mem::take(&mut prof.hits).into_iter().collect())
+}
+
+// called from the timer interrupt; the sample is dropped if the
+// profiler lock is contended
+pub fn sample(task_id: TaskId, rip: u64) {
+    let mut prof = match PROFILER.try_lock() {
+        Ok(prof) => prof,
+        Err(_) => return,
+    };
+
+    if prof.target != Some(task_id) {
+        return;
+    }
+
+    if prof.hits.len() >= MAX_SAMPLE_ADDRS && !prof.hits.contains_key(&rip) {
+        prof.dropped += 1;
+        return;
+    }
+
+    *prof.hits.entry(rip).or_insert(0) += 1;
+}
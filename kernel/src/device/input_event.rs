@@ -0,0 +1,81 @@
+use crate::{
+    error::Result,
+    fs::vfs::{self, FileDescriptorNumber},
+    sync::mutex::Mutex,
+    util::keyboard::{key_event::*, scan_code::KeyCode},
+};
+use alloc::vec::Vec;
+use libc_rs::*;
+
+static INPUT_EVENT_QUEUES: Mutex<Vec<InputEventQueue>> = Mutex::new(Vec::new());
+
+struct InputEventQueue {
+    read_fd: FileDescriptorNumber,
+    write_fd: FileDescriptorNumber,
+}
+
+// creates a pipe-backed event queue fed by the keyboard and mouse
+// drivers and returns its read end - records are packed input_event
+// structs, so one read drains a whole burst
+pub fn subscribe() -> Result<FileDescriptorNumber> {
+    let (read_fd, write_fd) = vfs::create_pipe()?;
+    INPUT_EVENT_QUEUES
+        .try_lock()?
+        .push(InputEventQueue { read_fd, write_fd });
+    Ok(read_fd)
+}
+
+pub fn is_event_fd(fd_num: FileDescriptorNumber) -> bool {
+    match INPUT_EVENT_QUEUES.try_lock() {
+        Ok(queues) => queues.iter().any(|q| q.read_fd == fd_num),
+        Err(_) => false,
+    }
+}
+
+fn push_event(event: input_event) {
+    let queues = match INPUT_EVENT_QUEUES.try_lock() {
+        Ok(queues) => queues,
+        Err(_) => return,
+    };
+
+    let bytes = unsafe {
+        core::slice::from_raw_parts(
+            &event as *const input_event as *const u8,
+            size_of::<input_event>(),
+        )
+    };
+    for queue in queues.iter() {
+        let _ = vfs::write_file(queue.write_fd, bytes);
+    }
+}
+
+pub fn push_key_event(e: &KeyEvent) {
+    let code = match e.code {
+        KeyCode::CursorUp => INPUT_KEY_UP as u16,
+        KeyCode::CursorDown => INPUT_KEY_DOWN as u16,
+        KeyCode::CursorLeft => INPUT_KEY_LEFT as u16,
+        KeyCode::CursorRight => INPUT_KEY_RIGHT as u16,
+        _ => match e.c {
+            Some(c) => c as u16,
+            None => return,
+        },
+    };
+
+    push_event(input_event {
+        type_: INPUT_EV_TYPE_KEY as u8,
+        pressed: (e.state == KeyState::Pressed) as u8,
+        code,
+        x: 0,
+        y: 0,
+    });
+}
+
+pub fn push_mouse_event(pos_x: usize, pos_y: usize, left: bool) {
+    push_event(input_event {
+        type_: INPUT_EV_TYPE_MOUSE as u8,
+        pressed: left as u8,
+        code: 0,
+        x: pos_x as i16,
+        y: pos_y as i16,
+    });
+}
@@ -9,15 +9,17 @@ use crate::{
     device::*,
     error::{Error, Result},
     kdebug, kinfo,
+    mem::bitmap::{self, MemoryFrame},
     sync::{mutex::Mutex, volatile::Volatile},
     task::{self, async_task},
     util::mmio::Mmio,
 };
 use alloc::vec::Vec;
 use core::time::Duration;
+use libc_rs::time_page;
 
 const DIV_VALUE: DivideValue = DivideValue::By1;
-const INT_INTERVAL_MS: usize = 10;
+pub const INT_INTERVAL_MS: usize = 10;
 
 #[allow(dead_code)]
 #[derive(Debug)]
@@ -55,6 +57,7 @@ struct LocalApicTimerDriver {
     device_driver_info: DeviceDriverInfo,
     tick: usize,
     freq: Option<usize>,
+    time_page_frame: Option<MemoryFrame>,
 
     lvt_timer_reg: Option<Mmio<Volatile<u32>>>,
     int_cnt_reg: Option<Mmio<Volatile<u32>>>,
@@ -68,6 +71,7 @@ impl LocalApicTimerDriver {
             device_driver_info: DeviceDriverInfo::new("local-apic-timer"),
             tick: 0,
             freq: None,
+            time_page_frame: None,
 
             lvt_timer_reg: None,
             int_cnt_reg: None,
@@ -99,6 +103,25 @@ impl LocalApicTimerDriver {
         u32::MAX as usize - current_cnt as usize
     }
 
+    // seqlock-style update of the shared time page: seq is odd while the
+    // fields are being rewritten, so userspace retries the read
+    fn update_time_page(&mut self) {
+        let frame = match &self.time_page_frame {
+            Some(frame) => frame,
+            None => return,
+        };
+
+        let uptime_ms = (self.tick * INT_INTERVAL_MS) as u64;
+        unsafe {
+            let page = frame.frame_start_virt_addr().as_ptr_mut::<time_page>();
+            let seq = core::ptr::addr_of_mut!((*page).seq);
+            seq.write_volatile(seq.read_volatile().wrapping_add(1));
+            core::ptr::addr_of_mut!((*page).uptime_ms).write_volatile(uptime_ms);
+            core::ptr::addr_of_mut!((*page).tsc_at_tick).write_volatile(rdtsc());
+            seq.write_volatile(seq.read_volatile().wrapping_add(1));
+        }
+    }
+
     fn current_ms(&mut self) -> Result<usize> {
         let _freq = self
             .freq
@@ -182,7 +205,9 @@ impl DeviceDriverFunction for LocalApicTimerDriver {
 
             self.int_cnt_reg().get_unchecked_mut().write(u32::MAX);
 
+            let tsc_start = rdtsc();
             tsc::wait_ms(1000)?; // wait 1 sec
+            let tsc_end = rdtsc();
 
             let remaining = self.curr_cnt_reg().as_ref().read();
             let ticks_per_second = (u32::MAX - remaining) as usize;
@@ -199,6 +224,15 @@ impl DeviceDriverFunction for LocalApicTimerDriver {
 
             self.freq = Some(ticks_per_second);
 
+            // allocate the shared time page (mapped read-only into tasks by
+            // sys_timepage) - the TSC frequency comes from the same 1 sec wait
+            let frame = bitmap::alloc_mem_frame(1)?;
+            let ptr = frame.frame_start_virt_addr().as_ptr_mut::<u8>();
+            ptr.write_bytes(0, paging::PAGE_SIZE);
+            let page = ptr as *mut time_page;
+            core::ptr::addr_of_mut!((*page).tsc_freq).write_volatile(tsc_end - tsc_start);
+            self.time_page_frame = Some(frame);
+
             // start timer
             self.start();
         }
@@ -222,6 +256,8 @@ impl DeviceDriverFunction for LocalApicTimerDriver {
             self.tick += 1;
         }
 
+        self.update_time_page();
+
         let _ = async_task::poll();
 
         Ok(())
@@ -278,6 +314,18 @@ pub fn write(data: &[u8]) -> Result<()> {
     driver.write(data)
 }
 
+// maps the shared time page (updated on every timer interrupt) read-only
+// into the current task and returns its virtual address
+pub fn map_time_page_to_current_task() -> Result<VirtualAddress> {
+    let driver = unsafe { LOCAL_APIC_TIMER_DRIVER.try_lock() }?;
+    let frame = driver
+        .time_page_frame
+        .as_ref()
+        .ok_or(Error::NotInitialized.with_context("time page"))?;
+    task::scheduler::current_map_user_page_readonly(frame)?;
+    Ok(frame.frame_start_virt_addr())
+}
+
 pub fn global_uptime() -> Duration {
     let driver = unsafe { LOCAL_APIC_TIMER_DRIVER.get_force_mut() };
     let ms = driver.current_ms().unwrap_or(0);
@@ -345,5 +393,14 @@ unsafe extern "sysv64" fn timer_preempt_handler(
     let _ = driver.poll_int();
     apic::notify_end_of_int();
 
+    // sample the interrupted rip for the profiler, but only when the
+    // timer landed in user code
+    let ctx = &*interrupted;
+    if ctx.cs & 3 == 3 {
+        if let Some(task_id) = task::scheduler::current_task_id() {
+            crate::debug::profiler::sample(task_id, ctx.rip);
+        }
+    }
+
     task::scheduler::preempt_sched(&*interrupted)
 }
@@ -1,6 +1,7 @@
 use crate::error::Result;
 use alloc::vec::Vec;
 
+pub mod input_event;
 pub mod local_apic_timer;
 pub mod panic_screen;
 pub mod pci_bus;
@@ -3,7 +3,7 @@ use crate::{
         x86_64::{self, idt},
         IoPortAddress,
     },
-    device::{tty, DeviceDriverFunction, DeviceDriverInfo},
+    device::{input_event, tty, DeviceDriverFunction, DeviceDriverInfo},
     error::{Error, Result},
     fs::vfs,
     kinfo,
@@ -202,6 +202,8 @@ pub fn poll_normal() -> Result<()> {
         None => return Ok(()),
     };
 
+    input_event::push_key_event(&key_event);
+
     match key_event.code {
         KeyCode::CursorUp => {
             tty::input('\x1b')?;
@@ -96,6 +96,8 @@ struct Tty {
     use_serial_port: bool,
     is_ready_get_line: bool,
     esc_state: EscState,
+    raw_mode: bool,
+    raw_timeout_ms: i32,
 }
 
 impl Tty {
@@ -108,6 +110,8 @@ impl Tty {
             use_serial_port,
             is_ready_get_line: false,
             esc_state: EscState::Normal,
+            raw_mode: false,
+            raw_timeout_ms: -1,
         }
     }
 
@@ -150,6 +154,41 @@ impl Tty {
         Ok(())
     }
 
+    // batched output path: the echo buffer and uart still see each char,
+    // but the framebuffer console is handed the whole string at once -
+    // one console lock and glyph pass per write instead of one per char
+    fn write_output_str(&mut self, s: &str) -> Result<()> {
+        for c in s.chars() {
+            match c {
+                '\x08' | '\x7f' => {
+                    let _ = self.output_buf.pop_back();
+                }
+                _ => {
+                    self.output_buf.push(c);
+                }
+            }
+
+            if self.use_serial_port {
+                let data = match c {
+                    '\x08' | '\x7f' => '\x08' as u8,
+                    _ => c as u8,
+                };
+
+                // backspace
+                if data == 0x08 {
+                    uart::send_data(data);
+                    uart::send_data(b' ');
+                    uart::send_data(data);
+                } else {
+                    uart::send_data(data);
+                }
+            }
+        }
+
+        let _ = frame_buf_console::write_str(s);
+        Ok(())
+    }
+
     fn line(&mut self, buf_type: BufferType) -> String {
         let buf = match buf_type {
             BufferType::Input => &mut self.input_buf,
@@ -200,7 +239,25 @@ impl Tty {
         self.is_ready_get_line = false;
     }
 
+    fn read_input_bytes(&mut self, max_len: usize) -> Vec<u8> {
+        let mut bytes = Vec::new();
+        while bytes.len() < max_len {
+            match self.input_buf.pop_front() {
+                Some(c) => bytes.push(c as u8),
+                None => break,
+            }
+        }
+        bytes
+    }
+
     fn input_char(&mut self, c: char) -> Result<()> {
+        // raw mode delivers every byte untouched - no echo, no line
+        // state, no escape tracking (the reader decodes sequences itself)
+        if self.raw_mode {
+            self.input_buf.push(c);
+            return Ok(());
+        }
+
         match c {
             '\x08' | '\x7f' => {
                 self.input_buf.push(c);
@@ -248,12 +305,7 @@ impl Tty {
 
 impl fmt::Write for Tty {
     fn write_str(&mut self, s: &str) -> fmt::Result {
-        let buf_type = BufferType::Output;
-        for c in s.chars() {
-            self.write(c, buf_type).map_err(|_| fmt::Error)?;
-        }
-
-        Ok(())
+        self.write_output_str(s).map_err(|_| fmt::Error)
     }
 }
 
@@ -356,11 +408,8 @@ pub fn read(offset: usize, max_len: usize) -> Result<Vec<u8>> {
 
 pub fn write(data: &[u8]) -> Result<()> {
     let mut driver = TTY.try_lock()?;
-    for &c in data {
-        driver.write(c as char, BufferType::Output)?;
-    }
-
-    Ok(())
+    let s: String = data.iter().map(|&c| c as char).collect();
+    driver.write_output_str(&s)
 }
 
 pub fn input(c: char) -> Result<()> {
@@ -405,3 +454,28 @@ pub fn input_count() -> Result<usize> {
     let tty = TTY.try_lock()?;
     Ok(tty.input_count())
 }
+
+// raw (non-canonical) mode: sys_read on stdin drains every buffered
+// input byte in one call instead of cooking lines or single chars
+pub fn set_raw_mode(enabled: bool, read_timeout_ms: i32) -> Result<()> {
+    let mut tty = TTY.try_lock()?;
+    tty.raw_mode = enabled;
+    tty.raw_timeout_ms = read_timeout_ms;
+    tty.esc_state = EscState::Normal;
+    Ok(())
+}
+
+// Some(read timeout in ms, negative blocks) while raw mode is active
+pub fn raw_read_config() -> Result<Option<i32>> {
+    let tty = TTY.try_lock()?;
+    Ok(if tty.raw_mode {
+        Some(tty.raw_timeout_ms)
+    } else {
+        None
+    })
+}
+
+pub fn read_input_bytes(max_len: usize) -> Result<Vec<u8>> {
+    let mut tty = TTY.try_lock()?;
+    Ok(tty.read_input_bytes(max_len))
+}
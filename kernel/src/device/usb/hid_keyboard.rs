@@ -1,6 +1,6 @@
 use crate::{
     device::{
-        self, tty,
+        self, input_event, tty,
         usb::{usb_bus::*, xhc::register::*, UsbDeviceDriverFunction},
     },
     error::{Error, Result},
@@ -98,6 +98,8 @@ impl UsbDeviceDriverFunction for UsbHidKeyboardDriver {
             );
 
             if let Some(e) = e {
+                input_event::push_key_event(&e);
+
                 if e.state == KeyState::Pressed {
                     match e.code {
                         KeyCode::CursorUp => {
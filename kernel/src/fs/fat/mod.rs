@@ -2,10 +2,13 @@ use super::path::Path;
 use crate::{
     error::{Error, Result},
     fs::vfs::{FileSystem, FsFileType, FsMetaData, VirtualFileSystemError},
+    sync::mutex::Mutex,
+    util::lru::LruCache,
 };
 use alloc::{
     collections::vec_deque::VecDeque,
     string::{String, ToString},
+    sync::Arc,
     vec::Vec,
 };
 use core::cmp::min;
@@ -26,9 +29,19 @@ struct FileMetaData {
     target_cluster_num: usize,
 }
 
+// the volume is memory mapped and read-only, so cached entries never go
+// stale; the caches exist to skip re-walking the FAT chain and the
+// directory entries on every call
+const FILE_CACHE_MAX_BYTES: usize = 8 * 1024 * 1024;
+const DIR_CACHE_MAX_DIRS: usize = 64;
+
 pub struct Fat {
     volume: FatVolume,
     root_cluster_num: usize,
+    // assembled file contents keyed by normalized absolute path
+    file_cache: Mutex<LruCache<String, Arc<Vec<u8>>>>,
+    // scanned directory listings keyed by the directory's first cluster
+    dir_cache: Mutex<LruCache<usize, Arc<Vec<FileMetaData>>>>,
 }
 
 impl FileSystem for Fat {
@@ -42,7 +55,7 @@ impl FileSystem for Fat {
 
         let names = self
             .scan_dir(current_dir_cluster_num)
-            .into_iter()
+            .iter()
             .map(|f| f.name.trim().to_string())
             .collect();
 
@@ -50,7 +63,7 @@ impl FileSystem for Fat {
     }
 
     fn read_file(&self, path: &Path, offset: usize, max_len: usize) -> Result<Vec<u8>> {
-        let (_, bytes) = self.file_by_abs_path(path)?;
+        let bytes = self.cached_file_bytes(path)?;
 
         let start = min(offset, bytes.len());
         let end = min(start.saturating_add(max_len), bytes.len());
@@ -76,6 +89,36 @@ impl FileSystem for Fat {
             size: meta.size,
         })
     }
+
+    // one directory scan instead of one per entry
+    fn read_dir_entries(&self, path: &Path) -> Result<Vec<(String, FsMetaData)>> {
+        let path = path.normalize();
+        let mut current_dir_cluster_num = None;
+
+        for dir_name in path.names() {
+            current_dir_cluster_num = Some(self.cluster_num(dir_name, current_dir_cluster_num)?);
+        }
+
+        let entries = self
+            .scan_dir(current_dir_cluster_num)
+            .iter()
+            .map(|f| {
+                let file_type = match f.attr {
+                    Attribute::Directory => FsFileType::Directory,
+                    _ => FsFileType::File,
+                };
+                (
+                    f.name.trim().to_string(),
+                    FsMetaData {
+                        file_type,
+                        size: f.size,
+                    },
+                )
+            })
+            .collect();
+
+        Ok(entries)
+    }
 }
 
 impl Fat {
@@ -85,9 +128,38 @@ impl Fat {
         Self {
             volume,
             root_cluster_num,
+            file_cache: Mutex::new(LruCache::new()),
+            dir_cache: Mutex::new(LruCache::new()),
         }
     }
 
+    // serve the whole file from the cache, assembling and inserting it
+    // on a miss
+    fn cached_file_bytes(&self, path: &Path) -> Result<Arc<Vec<u8>>> {
+        let key = path.normalize().to_string();
+
+        if let Some(bytes) = self.file_cache.spin_lock().get(&key) {
+            return Ok(bytes.clone());
+        }
+
+        let (_, bytes) = self.file_by_abs_path(path)?;
+        let bytes = Arc::new(bytes);
+
+        if bytes.len() <= FILE_CACHE_MAX_BYTES {
+            let mut cache = self.file_cache.spin_lock();
+            let mut total: usize = cache.values().map(|b| b.len()).sum();
+            while total + bytes.len() > FILE_CACHE_MAX_BYTES {
+                match cache.pop_lru() {
+                    Some((_, evicted)) => total -= evicted.len(),
+                    None => break,
+                }
+            }
+            cache.insert(key, bytes.clone());
+        }
+
+        Ok(bytes)
+    }
+
     fn cluster_num(&self, dir_name: &str, current_dir_cluster_num: Option<usize>) -> Result<usize> {
         if current_dir_cluster_num.is_none()
             || current_dir_cluster_num == Some(self.root_cluster_num)
@@ -166,11 +238,16 @@ impl Fat {
         Ok(file)
     }
 
-    fn scan_dir(&self, dir_cluster_num: Option<usize>) -> Vec<FileMetaData> {
+    fn scan_dir(&self, dir_cluster_num: Option<usize>) -> Arc<Vec<FileMetaData>> {
         let dir_cluster_num = match dir_cluster_num {
             Some(cluster_num) => cluster_num,
             None => self.root_cluster_num,
         };
+
+        if let Some(files) = self.dir_cache.spin_lock().get(&dir_cluster_num) {
+            return files.clone();
+        }
+
         let mut files = Vec::new();
 
         let mut lf_name_buf = VecDeque::new();
@@ -221,6 +298,15 @@ impl Fat {
             }
         }
 
+        let files = Arc::new(files);
+        let mut cache = self.dir_cache.spin_lock();
+        while cache.len() >= DIR_CACHE_MAX_DIRS {
+            if cache.pop_lru().is_none() {
+                break;
+            }
+        }
+        cache.insert(dir_cluster_num, files.clone());
+
         files
     }
 }
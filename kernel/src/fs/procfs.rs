@@ -4,18 +4,20 @@ use crate::{
         path::Path,
         vfs::{FileSystem, FsFileType, FsMetaData, VirtualFileSystemError},
     },
-    task::{scheduler, TaskId},
+    task::{scheduler, TaskId, TaskState},
     util::time,
 };
 use alloc::{
     string::{String, ToString},
     vec::Vec,
 };
-use core::cmp::min;
+use core::{cmp::min, ffi::c_char, mem::size_of, slice};
+use libc_rs::{pid_t, proc_stat, PROC_NAME_LEN};
 
 enum ProcNode {
     Root,
     Uptime,
+    Stat,
     TaskDir(TaskId),
     TaskStatus(TaskId),
 }
@@ -30,6 +32,47 @@ impl ProcNode {
                 let bytes = format!("{}.{:02}\n", ms / 1000, (ms % 1000) / 10);
                 Ok(bytes.as_bytes().to_vec())
             }
+            // one binary proc_stat record per task, so the whole table can be
+            // fetched with a single sys_read
+            Self::Stat => {
+                let mut snapshots = scheduler::task_snapshots();
+                snapshots.sort_unstable_by_key(|s| s.id);
+
+                let mut records: Vec<proc_stat> = Vec::with_capacity(snapshots.len());
+                for s in &snapshots {
+                    let mut rec: proc_stat = unsafe { core::mem::zeroed() };
+                    rec.pid = s.id.get() as pid_t;
+                    rec.ppid = s.parent.map_or(-1, |p| p.get() as pid_t);
+                    rec.state = match s.state {
+                        TaskState::Running => b'R',
+                        TaskState::Ready => b'Q',
+                        TaskState::Sleeping => b'S',
+                        TaskState::Exited(_) => b'X',
+                    } as c_char;
+                    for (i, b) in s
+                        .name
+                        .as_bytes()
+                        .iter()
+                        .take(PROC_NAME_LEN as usize - 1)
+                        .enumerate()
+                    {
+                        rec.name[i] = *b as c_char;
+                    }
+                    rec.cpu_time_ms = s.cpu_time_ms;
+                    rec.ctx_switches = s.ctx_switches;
+                    rec.syscalls = s.syscall_count;
+                    rec.heap_bytes = s.heap_bytes;
+                    records.push(rec);
+                }
+
+                let bytes = unsafe {
+                    slice::from_raw_parts(
+                        records.as_ptr() as *const u8,
+                        records.len() * size_of::<proc_stat>(),
+                    )
+                };
+                Ok(bytes.to_vec())
+            }
             Self::TaskDir(_) => Err(VirtualFileSystemError::NotFile(None).into()),
             Self::TaskStatus(task_id) => {
                 let s = scheduler::task_snapshot(*task_id)
@@ -60,6 +103,10 @@ impl ProcNode {
                 file_type: FsFileType::File,
                 size: 0,
             },
+            Self::Stat => FsMetaData {
+                file_type: FsFileType::File,
+                size: 0,
+            },
             Self::TaskDir(_) => FsMetaData {
                 file_type: FsFileType::Directory,
                 size: 0,
@@ -78,7 +125,7 @@ impl FileSystem for ProcFs {
     fn read_entry_names(&self, path: &Path) -> Result<Vec<String>> {
         match self.path_to_node(&path.normalize())? {
             ProcNode::Root => {
-                let mut names = vec!["uptime".to_string(), "self".to_string()];
+                let mut names = vec!["uptime".to_string(), "stat".to_string(), "self".to_string()];
 
                 let mut task_ids = scheduler::task_ids();
                 task_ids.sort_unstable();
@@ -120,6 +167,7 @@ impl ProcFs {
         match normalized_path.names().as_slice() {
             [] => Ok(ProcNode::Root),
             ["uptime"] => Ok(ProcNode::Uptime),
+            ["stat"] => Ok(ProcNode::Stat),
             [pid] => Ok(ProcNode::TaskDir(resolve_task_id(pid, normalized_path)?)),
             [pid, "status"] => Ok(ProcNode::TaskStatus(resolve_task_id(pid, normalized_path)?)),
             _ => Err(
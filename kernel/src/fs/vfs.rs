@@ -4,6 +4,7 @@ use crate::{
     error::{Error, Result},
     kwarn,
     sync::mutex::Mutex,
+    util::lru::LruCache,
 };
 use alloc::{
     boxed::Box,
@@ -152,6 +153,17 @@ pub trait FileSystem {
     fn read_file(&self, path: &Path, offset: usize, max_len: usize) -> Result<Vec<u8>>;
     fn write_file(&self, path: &Path, offset: usize, data: &[u8]) -> Result<()>;
     fn metadata(&self, path: &Path) -> Result<FsMetaData>;
+
+    // implementations that scan directories anyway should override this
+    // to avoid one metadata lookup per entry
+    fn read_dir_entries(&self, path: &Path) -> Result<Vec<(String, FsMetaData)>> {
+        let mut entries = Vec::new();
+        for name in self.read_entry_names(path)? {
+            let metadata = self.metadata(&path.join(&name))?;
+            entries.push((name, metadata));
+        }
+        Ok(entries)
+    }
 }
 
 struct FileInfo {
@@ -321,11 +333,17 @@ impl core::fmt::Display for VirtualFileSystemError {
     }
 }
 
+// cached (parent directory, component name) lookups kept across calls
+const DENTRY_CACHE_MAX_ENTRIES: usize = 256;
+
 struct VirtualFileSystem {
     cwd_path: Option<Path>,
     root_id: Option<VfsFileId>,
     files: BTreeMap<VfsFileId, FileInfo>,
     fds: Vec<FileDescriptor>,
+    // resolves one path component without scanning the parent's
+    // children; entries are dropped when the child is removed
+    dentry_cache: Mutex<LruCache<(VfsFileId, String), VfsFileId>>,
 }
 
 impl VirtualFileSystem {
@@ -335,6 +353,7 @@ impl VirtualFileSystem {
             root_id: None,
             files: BTreeMap::new(),
             fds: Vec::new(),
+            dentry_cache: Mutex::new(LruCache::new()),
         }
     }
 
@@ -407,10 +426,32 @@ impl VirtualFileSystem {
                 return resolve_mount(file_id, fs.as_ref(), rel_path);
             }
 
+            let key = (file_id, name.to_string());
+            let cached_id = self.dentry_cache.spin_lock().get(&key).copied();
+            if let Some(child_id) = cached_id {
+                if let Some(child_ref) = self.find_file(child_id) {
+                    if child_ref.name == *name {
+                        file_ref = child_ref;
+                        file_id = child_id;
+                        continue;
+                    }
+                }
+                self.dentry_cache.spin_lock().remove(&key);
+            }
+
             let mut found = false;
             for child_id in &file_ref.children {
                 let child_ref = self.find_file(*child_id)?;
                 if child_ref.name == *name {
+                    let mut cache = self.dentry_cache.spin_lock();
+                    while cache.len() >= DENTRY_CACHE_MAX_ENTRIES {
+                        if cache.pop_lru().is_none() {
+                            break;
+                        }
+                    }
+                    cache.insert(key, *child_id);
+                    drop(cache);
+
                     file_ref = child_ref;
                     file_id = *child_id;
                     found = true;
@@ -464,6 +505,38 @@ impl VirtualFileSystem {
         Ok(names)
     }
 
+    fn dir_entries(&self, path: &Path) -> Result<Vec<(String, FsMetaData)>> {
+        let resolved =
+            self.find_file_by_path(path)
+                .ok_or(VirtualFileSystemError::NoSuchFileOrDirectory(Some(
+                    path.clone(),
+                )))?;
+
+        if resolved.vfs_type() != VfsFileType::Directory {
+            return Err(VirtualFileSystemError::NotDirectory(Some(path.clone())).into());
+        }
+
+        let mut entries = match resolved {
+            Resolved::Vfs(_, file_ref) => file_ref
+                .children
+                .iter()
+                .filter_map(|id| self.find_file(*id))
+                .map(|f| {
+                    let file_type = match &f.ty {
+                        VfsFileType::Directory => FsFileType::Directory,
+                        _ => FsFileType::File,
+                    };
+                    let size = f.buf.as_ref().map_or(0, |b| b.len());
+                    (f.name.clone(), FsMetaData { file_type, size })
+                })
+                .collect(),
+            Resolved::Fs { fs, rel_path, .. } => fs.read_dir_entries(&rel_path)?,
+        };
+        entries.retain(|(n, _)| n.as_str() != Path::CURRENT_DIR && n.as_str() != Path::PARENT_DIR);
+
+        Ok(entries)
+    }
+
     fn chdir(&mut self, path: &Path) -> Result<()> {
         let abs_path = self.absolutize(path).ok_or(Error::NotInitialized)?;
 
@@ -671,7 +744,11 @@ impl VirtualFileSystem {
         }
 
         if remaining == 0 {
-            self.files.remove(&file_id);
+            if let Some(info) = self.files.remove(&file_id) {
+                self.dentry_cache
+                    .spin_lock()
+                    .remove(&(info.parent, info.name));
+            }
             return;
         }
 
@@ -710,8 +787,38 @@ impl VirtualFileSystem {
     }
 
     fn read_file(&mut self, fd_num: FileDescriptorNumber, max_len: usize) -> Result<ReadOutcome> {
-        let backing = self.file_desc(fd_num)?.backing.clone();
         let offset = self.file_desc(fd_num)?.offset;
+        let (outcome, new_offset) = self.read_file_inner(fd_num, offset, max_len)?;
+
+        if let Some(new_offset) = new_offset {
+            self.file_desc_mut(fd_num)?.offset = new_offset;
+        }
+
+        Ok(outcome)
+    }
+
+    // positional read: explicit offset, shared fd position untouched
+    fn read_file_at(
+        &mut self,
+        fd_num: FileDescriptorNumber,
+        offset: usize,
+        max_len: usize,
+    ) -> Result<ReadOutcome> {
+        if self.file_desc(fd_num)?.pipe_end.is_some() {
+            return Err(Error::InvalidData.with_context("positional read on pipe"));
+        }
+
+        let (outcome, _) = self.read_file_inner(fd_num, offset, max_len)?;
+        Ok(outcome)
+    }
+
+    fn read_file_inner(
+        &mut self,
+        fd_num: FileDescriptorNumber,
+        offset: usize,
+        max_len: usize,
+    ) -> Result<(ReadOutcome, Option<usize>)> {
+        let backing = self.file_desc(fd_num)?.backing.clone();
 
         match backing {
             FileBacking::Fs { mount_id, rel_path } => {
@@ -727,8 +834,7 @@ impl VirtualFileSystem {
                 let end = min(start.saturating_add(max_len), content.len());
                 let bytes = content[start..end].to_vec();
 
-                self.file_desc_mut(fd_num)?.offset = end;
-                Ok(ReadOutcome::Data(bytes))
+                Ok((ReadOutcome::Data(bytes), Some(end)))
             }
             FileBacking::Vfs(file_id) => {
                 let ty = self.file_ref(file_id)?.ty.clone();
@@ -743,19 +849,22 @@ impl VirtualFileSystem {
 
                         if pipe.buf.is_empty() {
                             return if pipe.write_closed {
-                                Ok(ReadOutcome::Data(Vec::new()))
+                                Ok((ReadOutcome::Data(Vec::new()), None))
                             } else {
                                 Err(Error::BufferEmpty.into())
                             };
                         }
 
                         let len = min(max_len, pipe.buf.len());
-                        Ok(ReadOutcome::Data(pipe.buf.drain(..len).collect()))
+                        Ok((ReadOutcome::Data(pipe.buf.drain(..len).collect()), None))
                     }
-                    VfsFileType::DeviceFile(desc) => Ok(ReadOutcome::Device {
-                        read: desc.read,
-                        offset,
-                    }),
+                    VfsFileType::DeviceFile(desc) => Ok((
+                        ReadOutcome::Device {
+                            read: desc.read,
+                            offset,
+                        },
+                        None,
+                    )),
                     VfsFileType::VirtualFile => {
                         let file_ref = self.file_ref(file_id)?;
                         let buf: &[u8] = file_ref.buf.as_deref().unwrap_or(&[]);
@@ -763,8 +872,7 @@ impl VirtualFileSystem {
                         let end = min(start.saturating_add(max_len), buf.len());
                         let bytes = buf[start..end].to_vec();
 
-                        self.file_desc_mut(fd_num)?.offset = end;
-                        Ok(ReadOutcome::Data(bytes))
+                        Ok((ReadOutcome::Data(bytes), Some(end)))
                     }
                     VfsFileType::Directory => {
                         let file_path = self.abs_path_by_file(self.file_ref(file_id)?);
@@ -776,8 +884,38 @@ impl VirtualFileSystem {
     }
 
     fn write_file(&mut self, fd_num: FileDescriptorNumber, data: &[u8]) -> Result<WriteOutcome> {
-        let backing = self.file_desc(fd_num)?.backing.clone();
         let offset = self.file_desc(fd_num)?.offset;
+        let (outcome, new_offset) = self.write_file_inner(fd_num, offset, data)?;
+
+        if let Some(new_offset) = new_offset {
+            self.file_desc_mut(fd_num)?.offset = new_offset;
+        }
+
+        Ok(outcome)
+    }
+
+    // positional write: explicit offset, shared fd position untouched
+    fn write_file_at(
+        &mut self,
+        fd_num: FileDescriptorNumber,
+        offset: usize,
+        data: &[u8],
+    ) -> Result<WriteOutcome> {
+        if self.file_desc(fd_num)?.pipe_end.is_some() {
+            return Err(Error::InvalidData.with_context("positional write on pipe"));
+        }
+
+        let (outcome, _) = self.write_file_inner(fd_num, offset, data)?;
+        Ok(outcome)
+    }
+
+    fn write_file_inner(
+        &mut self,
+        fd_num: FileDescriptorNumber,
+        offset: usize,
+        data: &[u8],
+    ) -> Result<(WriteOutcome, Option<usize>)> {
+        let backing = self.file_desc(fd_num)?.backing.clone();
 
         match backing {
             FileBacking::Fs { mount_id, rel_path } => {
@@ -794,8 +932,7 @@ impl VirtualFileSystem {
                     }
                 }
 
-                self.file_desc_mut(fd_num)?.offset = offset + data.len();
-                Ok(WriteOutcome::Done)
+                Ok((WriteOutcome::Done, Some(offset + data.len())))
             }
             FileBacking::Vfs(file_id) => {
                 let ty = self.file_ref(file_id)?.ty.clone();
@@ -819,10 +956,9 @@ impl VirtualFileSystem {
 
                         buf_mut[offset..end].copy_from_slice(data);
 
-                        self.file_desc_mut(fd_num)?.offset = end;
-                        Ok(WriteOutcome::Done)
+                        Ok((WriteOutcome::Done, Some(end)))
                     }
-                    VfsFileType::DeviceFile(desc) => Ok(WriteOutcome::Device(desc.write)),
+                    VfsFileType::DeviceFile(desc) => Ok((WriteOutcome::Device(desc.write), None)),
                     VfsFileType::Pipe => {
                         let pipe = self
                             .file_ref_mut(file_id)?
@@ -830,7 +966,7 @@ impl VirtualFileSystem {
                             .as_mut()
                             .ok_or(VirtualFileSystemError::NoSuchFileOrDirectory(None))?;
                         pipe.buf.extend(data);
-                        Ok(WriteOutcome::Done)
+                        Ok((WriteOutcome::Done, None))
                     }
                     VfsFileType::Directory => {
                         let file_path = self.abs_path_by_file(self.file_ref(file_id)?);
@@ -931,6 +1067,11 @@ pub fn entry_names(path: &Path) -> Result<Vec<String>> {
     vfs.entry_names(path)
 }
 
+pub fn dir_entries(path: &Path) -> Result<Vec<(String, FsMetaData)>> {
+    let vfs = VFS.spin_lock();
+    vfs.dir_entries(path)
+}
+
 pub fn cwd_path() -> Result<Path> {
     let vfs = VFS.spin_lock();
     vfs.cwd_path.clone().ok_or(Error::NotInitialized.into())
@@ -987,6 +1128,47 @@ pub fn read_file(fd_num: FileDescriptorNumber, buf_len: usize) -> Result<Vec<u8>
     }
 }
 
+pub fn read_file_at(
+    fd_num: FileDescriptorNumber,
+    offset: usize,
+    buf_len: usize,
+) -> Result<Vec<u8>> {
+    let outcome = {
+        let mut vfs = VFS.spin_lock();
+        vfs.read_file_at(fd_num, offset, buf_len)?
+    };
+
+    match outcome {
+        ReadOutcome::Data(bytes) => Ok(bytes),
+        ReadOutcome::Device { read, offset } => read(offset, buf_len),
+    }
+}
+
+// readiness check for sys_poll: only pipes can make a read wait, so
+// everything else counts as readable
+pub fn is_fd_readable(fd_num: FileDescriptorNumber) -> Result<bool> {
+    let vfs = VFS.spin_lock();
+
+    let backing = vfs.file_desc(fd_num)?.backing.clone();
+    match backing {
+        FileBacking::Fs { .. } => Ok(true),
+        FileBacking::Vfs(file_id) => {
+            let file = vfs.file_ref(file_id)?;
+            match &file.ty {
+                VfsFileType::Pipe => {
+                    let pipe = file
+                        .pipe_buf
+                        .as_ref()
+                        .ok_or(VirtualFileSystemError::NoSuchFileOrDirectory(None))?;
+                    // a closed pipe is "readable": the read returns EOF
+                    Ok(!pipe.buf.is_empty() || pipe.write_closed)
+                }
+                _ => Ok(true),
+            }
+        }
+    }
+}
+
 pub fn write_file(fd_num: FileDescriptorNumber, data: &[u8]) -> Result<()> {
     let outcome = {
         let mut vfs = VFS.spin_lock();
@@ -999,6 +1181,18 @@ pub fn write_file(fd_num: FileDescriptorNumber, data: &[u8]) -> Result<()> {
     }
 }
 
+pub fn write_file_at(fd_num: FileDescriptorNumber, offset: usize, data: &[u8]) -> Result<()> {
+    let outcome = {
+        let mut vfs = VFS.spin_lock();
+        vfs.write_file_at(fd_num, offset, data)?
+    };
+
+    match outcome {
+        WriteOutcome::Done => Ok(()),
+        WriteOutcome::Device(write) => write(data),
+    }
+}
+
 pub fn file_size(fd_num: FileDescriptorNumber) -> Result<usize> {
     let vfs = VFS.spin_lock();
     vfs.file_size(fd_num)
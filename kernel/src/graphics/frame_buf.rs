@@ -270,6 +270,24 @@ pub fn draw_char(
     fb.draw_char(point, c, fore_color, back_color)
 }
 
+// one lock acquisition for a whole run of glyphs
+pub fn draw_text(
+    point: Point,
+    s: &str,
+    fore_color: ColorCode,
+    back_color: ColorCode,
+) -> Result<()> {
+    let mut fb = FB.try_lock()?;
+    let f_w = crate::graphics::font::FONT.wh().0;
+    let mut x = point.x;
+    for c in s.chars() {
+        fb.draw_char(Point::new(x, point.y), c, fore_color, back_color)?;
+        x += f_w;
+    }
+
+    Ok(())
+}
+
 pub fn enable_shadow_buf() -> Result<()> {
     let mut fb = FB.try_lock()?;
     fb.enable_shadow_buf()
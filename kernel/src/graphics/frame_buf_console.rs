@@ -308,8 +308,53 @@ impl FrameBufferConsole {
     }
 
     fn write_str(&mut self, s: &str) -> Result<()> {
-        for c in s.chars() {
+        let (f_w, f_h) = FONT.wh();
+        let mut rest = s;
+
+        while !rest.is_empty() {
+            // batch a run of plain printable chars on the current line into
+            // a single locked draw instead of one blit per glyph
+            if self.ansi_escape_stream.is_idle() && !self.is_hidden {
+                let (cursor_max_x, cursor_max_y) = self.cursor_max()?;
+                let room = cursor_max_x + 1 - self.cursor_x;
+
+                let mut run_chars = 0;
+                let mut run_bytes = 0;
+                for c in rest.chars() {
+                    if run_chars >= room || matches!(c, '\n' | '\t' | '\x08' | '\x7f' | '\x1b') {
+                        break;
+                    }
+                    run_chars += 1;
+                    run_bytes += c.len_utf8();
+                }
+
+                if run_chars > 1 {
+                    self.flush_scroll()?;
+                    let point = Point::new(self.cursor_x * f_w, self.cursor_y * f_h);
+                    self.draw_text(point, &rest[..run_bytes], self.fore_color, self.back_color)?;
+
+                    self.cursor_x += run_chars;
+                    if self.cursor_x > cursor_max_x {
+                        self.cursor_x = 0;
+                        self.cursor_y += 1;
+                        if self.cursor_y > cursor_max_y {
+                            self.scroll();
+                            self.cursor_y = cursor_max_y;
+                        }
+                    }
+
+                    rest = &rest[run_bytes..];
+                    continue;
+                }
+            }
+
+            let mut chars = rest.char_indices();
+            let (_, c) = chars.next().unwrap();
             self.write_char(c)?;
+            rest = match chars.next() {
+                Some((i, _)) => &rest[i..],
+                None => "",
+            };
         }
 
         Ok(())
@@ -443,6 +488,30 @@ impl FrameBufferConsole {
         Ok(())
     }
 
+    fn draw_text(
+        &self,
+        point: Point,
+        s: &str,
+        fore_color: ColorCode,
+        back_color: ColorCode,
+    ) -> Result<()> {
+        if let Some(layer_id) = &self.target_layer_id {
+            let f_w = FONT.wh().0;
+            multi_layer::draw_layer(*layer_id, |l| {
+                let mut x = point.x;
+                for c in s.chars() {
+                    l.draw_char(Point::new(x, point.y), c, fore_color, back_color)?;
+                    x += f_w;
+                }
+                Ok(())
+            })?;
+        } else {
+            frame_buf::draw_text(point, s, fore_color, back_color)?;
+        }
+
+        Ok(())
+    }
+
     fn backspace(&mut self) -> Result<()> {
         let (f_w, f_h) = FONT.wh();
 
@@ -483,3 +552,10 @@ pub fn write_char(c: char) -> Result<()> {
     let _ = FRAME_BUF_CONSOLE.try_lock()?.write_char(c);
     Ok(())
 }
+
+// batched variant: one console lock per call instead of one per char,
+// so sustained output is not serialized on lock traffic
+pub fn write_str(s: &str) -> Result<()> {
+    let _ = FRAME_BUF_CONSOLE.try_lock()?.write_str(s);
+    Ok(())
+}
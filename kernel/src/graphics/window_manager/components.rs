@@ -67,6 +67,14 @@ pub trait Component {
         self.move_by_root(to_pos + (pos - p_pos))
     }
     fn draw_flush(&mut self) -> Result<()>;
+    // only image components accept damage rectangles
+    fn add_damage(&mut self, _rect: Rect) -> Result<()> {
+        Err(Error::InvalidData.with_context("component does not accept damage rectangles"))
+    }
+    // only image components sample a client framebuf
+    fn flip_framebuf(&mut self, _framebuf_virt_addr: VirtualAddress) -> Result<()> {
+        Err(Error::InvalidData.with_context("component does not sample a framebuf"))
+    }
 }
 
 pub struct Image {
@@ -74,6 +82,10 @@ pub struct Image {
     framebuf_virt_addr: Option<VirtualAddress>,
     pixel_format: Option<PixelFormat>,
     buf: Option<Vec<u32>>,
+    // damage rectangles submitted since the last flush - once the client
+    // starts flushing explicitly, only these regions are reconverted
+    damage: Vec<Rect>,
+    use_damage: bool,
 }
 
 impl Drop for Image {
@@ -87,6 +99,28 @@ impl Component for Image {
         self.layer_id
     }
 
+    fn add_damage(&mut self, rect: Rect) -> Result<()> {
+        self.use_damage = true;
+        self.damage.push(rect);
+        Ok(())
+    }
+
+    fn flip_framebuf(&mut self, framebuf_virt_addr: VirtualAddress) -> Result<()> {
+        if self.framebuf_virt_addr.is_none() {
+            return Err(Error::InvalidData.with_context("component does not sample a framebuf"));
+        }
+
+        // the compositor samples whichever buffer this points at, so
+        // swapping the pointer is the whole flip - the next draw_flush
+        // reconverts the full surface from the new front buffer while the
+        // client renders into the retired one
+        self.framebuf_virt_addr = Some(framebuf_virt_addr);
+        let size = self.layer_info()?.size;
+        self.damage.clear();
+        self.damage.push(Rect::new(0, 0, size.width, size.height));
+        Ok(())
+    }
+
     fn draw_flush(&mut self) -> Result<()> {
         let framebuf_virt_addr = match self.framebuf_virt_addr {
             Some(addr) => addr,
@@ -112,25 +146,45 @@ impl Component for Image {
         };
 
         // convert image to buffer
+        let buf_converted = self.buf.as_ref().map_or(false, |b| b.len() == w * h);
         let buf = self.buf.get_or_insert_with(|| Vec::with_capacity(w * h));
         if buf.len() != w * h {
             buf.resize(w * h, 0);
         }
 
+        // clients that flush explicitly only get their damaged regions
+        // reconverted - legacy clients keep the full reconvert per flush
+        let damage = if self.use_damage && buf_converted {
+            if self.damage.is_empty() {
+                return Ok(());
+            }
+            core::mem::take(&mut self.damage)
+        } else {
+            self.damage.clear();
+            alloc::vec![Rect::new(0, 0, w, h)]
+        };
+
         let framebuf_slice: &[u8] =
             unsafe { core::slice::from_raw_parts(framebuf_virt_addr.as_ptr(), w * h * bytes) };
 
         let buf_ptr = buf.as_mut_ptr();
 
-        for y in 0..h {
-            for x in 0..w {
-                let offset = (y * w + x) * bytes;
-                let pixel_color =
-                    ColorCode::from_pixel_data(&framebuf_slice[offset..], pixel_format);
-                unsafe {
-                    buf_ptr
-                        .add(y * w + x)
-                        .write(pixel_color.to_color_code(layer_format));
+        for rect in &damage {
+            let x_start = rect.origin.x.min(w);
+            let y_start = rect.origin.y.min(h);
+            let x_end = (rect.origin.x + rect.size.width).min(w);
+            let y_end = (rect.origin.y + rect.size.height).min(h);
+
+            for y in y_start..y_end {
+                for x in x_start..x_end {
+                    let offset = (y * w + x) * bytes;
+                    let pixel_color =
+                        ColorCode::from_pixel_data(&framebuf_slice[offset..], pixel_format);
+                    unsafe {
+                        buf_ptr
+                            .add(y * w + x)
+                            .write(pixel_color.to_color_code(layer_format));
+                    }
                 }
             }
         }
@@ -161,6 +215,8 @@ impl Image {
             framebuf_virt_addr: None,
             pixel_format: None,
             buf: None,
+            damage: Vec::new(),
+            use_damage: false,
         })
     }
 
@@ -180,8 +236,11 @@ impl Image {
             framebuf_virt_addr,
             pixel_format,
             buf: None,
+            damage: Vec::new(),
+            use_damage: false,
         })
     }
+
 }
 
 pub struct Window {
@@ -352,6 +411,28 @@ impl Window {
         Ok(child_layer_id)
     }
 
+    pub fn damage_child(&mut self, layer_id: LayerId, rect: Rect) -> Result<()> {
+        let child = self
+            .children
+            .iter_mut()
+            .find(|c| c.layer_id() == layer_id)
+            .ok_or(Error::NotFound.with_context("component"))?;
+        child.add_damage(rect)
+    }
+
+    pub fn flip_child(
+        &mut self,
+        layer_id: LayerId,
+        framebuf_virt_addr: VirtualAddress,
+    ) -> Result<()> {
+        let child = self
+            .children
+            .iter_mut()
+            .find(|c| c.layer_id() == layer_id)
+            .ok_or(Error::NotFound.with_context("component"))?;
+        child.flip_framebuf(framebuf_virt_addr)
+    }
+
     pub fn remove_child(&mut self, layer_id: LayerId) -> Result<()> {
         if let Some(pos) = self.children.iter().position(|c| c.layer_id() == layer_id) {
             self.children.remove(pos);
@@ -3,7 +3,8 @@ use super::{
     multi_layer::{LayerId, LayerInfo},
 };
 use crate::{
-    device::{ps2_mouse::Ps2MouseEvent, usb::hid_tablet::UsbHidMouseEvent},
+    arch::VirtualAddress,
+    device::{input_event, ps2_mouse::Ps2MouseEvent, usb::hid_tablet::UsbHidMouseEvent},
     error::{Error, Result},
     fs::{file::bitmap::BitmapImage, vfs},
     sync::mutex::Mutex,
@@ -156,6 +157,10 @@ impl WindowManager {
             MouseEvent::UsbHidMouse(e) => e.left,
         };
 
+        // both sources are unified to an absolute position here, so this
+        // is the one place to feed mouse records to input event queues
+        input_event::push_mouse_event(m_pos_after.x, m_pos_after.y, e_left);
+
         // click window event
         if e_left {
             if self.dragging_window_id.is_none() {
@@ -287,6 +292,44 @@ impl WindowManager {
         window.push_child(component)
     }
 
+    fn flush_component_image(&mut self, layer_id: LayerId, rect: Rect) -> Result<()> {
+        if self.res.is_none() {
+            return Err(Error::NotInitialized.into());
+        }
+
+        for window in self.windows.iter_mut() {
+            if window.damage_child(layer_id, rect).is_ok() {
+                return Ok(());
+            }
+        }
+
+        Err(WindowManagerError::WindowWasNotFound {
+            layer_id: layer_id.get(),
+        }
+        .into())
+    }
+
+    fn flip_component_image(
+        &mut self,
+        layer_id: LayerId,
+        framebuf_virt_addr: VirtualAddress,
+    ) -> Result<()> {
+        if self.res.is_none() {
+            return Err(Error::NotInitialized.into());
+        }
+
+        for window in self.windows.iter_mut() {
+            if window.flip_child(layer_id, framebuf_virt_addr).is_ok() {
+                return Ok(());
+            }
+        }
+
+        Err(WindowManagerError::WindowWasNotFound {
+            layer_id: layer_id.get(),
+        }
+        .into())
+    }
+
     fn remove_component(&mut self, layer_id: LayerId) -> Result<()> {
         if self.res.is_none() {
             return Err(Error::NotInitialized.into());
@@ -407,6 +450,16 @@ pub fn add_component_to_window(
         .add_component_to_window(layer_id, component)
 }
 
+pub fn flush_component_image(layer_id: LayerId, rect: Rect) -> Result<()> {
+    WINDOW_MAN.try_lock()?.flush_component_image(layer_id, rect)
+}
+
+pub fn flip_component_image(layer_id: LayerId, framebuf_virt_addr: VirtualAddress) -> Result<()> {
+    WINDOW_MAN
+        .try_lock()?
+        .flip_component_image(layer_id, framebuf_virt_addr)
+}
+
 pub fn remove_component(layer_id: LayerId) -> Result<()> {
     WINDOW_MAN.try_lock()?.remove_component(layer_id)
 }
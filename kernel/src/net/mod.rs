@@ -3,7 +3,7 @@ use crate::{
     device,
     error::{Error, Result},
     kinfo, kwarn,
-    net::{arp::*, eth::*, icmp::*, ip::*, socket::*, tcp::*, udp::*},
+    net::{arp::*, eth::*, icmp::*, ip::*, recv_ring::RecvRing, socket::*, tcp::*, udp::*},
     sync::mutex::Mutex,
 };
 use alloc::{collections::btree_map::BTreeMap, vec::Vec};
@@ -14,6 +14,7 @@ pub mod checksum;
 pub mod eth;
 pub mod icmp;
 pub mod ip;
+pub mod recv_ring;
 pub mod socket;
 pub mod tcp;
 pub mod udp;
@@ -216,6 +217,33 @@ impl NetworkManager {
         Err(Error::NotFound.with_context("incoming connection"))
     }
 
+    // readiness check for sys_poll: would a recv (or accept on a
+    // listening socket) complete without sleeping?
+    fn is_socket_readable(&mut self, socket_id: SocketId) -> Result<bool> {
+        let socket = self.socket_table.socket_mut_by_id(socket_id)?;
+        if socket.kind() == SocketType::Dgram {
+            let udp_socket = socket.inner_udp_mut()?;
+            return Ok(udp_socket.buf_len() > 0 || udp_socket.recv_ring_readable());
+        }
+
+        let port = socket.port();
+        let tcp_socket = socket.inner_tcp_mut()?;
+        let state = tcp_socket.state();
+        let has_data = tcp_socket.buf_len() > 0 || tcp_socket.recv_ring_readable();
+
+        let readable = match state {
+            TcpSocketState::Listen => self
+                .socket_table
+                .find_tcp_established_socket(port)
+                .is_some(),
+            TcpSocketState::Established => has_data,
+            TcpSocketState::Closed | TcpSocketState::SynSent | TcpSocketState::SynReceived => false,
+            // past established a recv returns buffered data or EOF
+            _ => true,
+        };
+        Ok(readable)
+    }
+
     fn connect_tcp_v4(
         &mut self,
         socket_id: SocketId,
@@ -260,7 +288,7 @@ impl NetworkManager {
             tcp_socket.seq_num(),
             0,
             TcpPacket::FLAGS_SYN,
-            u16::MAX,
+            tcp_socket.recv_window(),
             0,
             Vec::new(),
             Vec::new(),
@@ -293,7 +321,7 @@ impl NetworkManager {
     }
 
     fn send_tcp_fin(&mut self, socket_id: SocketId) -> Result<()> {
-        let (src_port, dst_port, dst_addr, seq_num, ack_num) = {
+        let (src_port, dst_port, dst_addr, seq_num, ack_num, window) = {
             let socket = self.socket_table.socket_mut_by_id(socket_id)?;
             let src_port = socket.port();
             if let Ok(tcp_socket) = socket.inner_tcp_mut() {
@@ -314,6 +342,7 @@ impl NetworkManager {
                     dst_addr,
                     tcp_socket.seq_num(),
                     tcp_socket.next_recv_seq(),
+                    tcp_socket.recv_window(),
                 )
             } else {
                 return Ok(());
@@ -326,7 +355,7 @@ impl NetworkManager {
             seq_num,
             ack_num,
             TcpPacket::FLAGS_ACK | TcpPacket::FLAGS_FIN,
-            u16::MAX,
+            window,
             0,
             Vec::new(),
             Vec::new(),
@@ -363,8 +392,10 @@ impl NetworkManager {
         Ok(())
     }
 
-    fn send_tcp_packet(&mut self, socket_id: SocketId, data: &[u8]) -> Result<()> {
-        let (src_port, dst_port, dst_addr, seq_num, ack_num) = {
+    // takes ownership of the payload so gathered (sendmsg) data goes
+    // into the packet without another copy
+    fn send_tcp_data(&mut self, socket_id: SocketId, data: Vec<u8>) -> Result<()> {
+        let (src_port, dst_port, dst_addr, seq_num, ack_num, window) = {
             let socket = self.socket_table.socket_mut_by_id(socket_id)?;
             let src_port = socket.port();
             let tcp_socket = socket.inner_tcp_mut()?;
@@ -386,19 +417,21 @@ impl NetworkManager {
                 dst_addr,
                 tcp_socket.seq_num(),
                 tcp_socket.next_recv_seq(),
+                tcp_socket.recv_window(),
             )
         };
 
+        let data_len = data.len();
         let mut packet = TcpPacket::new_with(
             src_port,
             dst_port,
             seq_num,
             ack_num,
             TcpPacket::FLAGS_ACK | TcpPacket::FLAGS_PSH,
-            u16::MAX,
+            window,
             0,
             Vec::new(),
-            data.to_vec(),
+            data,
         );
         packet.calc_checksum_with_ipv4(self.my_ipv4_addr, dst_addr);
 
@@ -425,10 +458,10 @@ impl NetworkManager {
             EthernetType::Ipv4,
         )?;
 
-        if !data.is_empty() {
+        if data_len > 0 {
             let socket = self.socket_table.socket_mut_by_id(socket_id)?;
             let tcp_socket = socket.inner_tcp_mut()?;
-            tcp_socket.add_seq_num(data.len() as u32);
+            tcp_socket.add_seq_num(data_len as u32);
         }
 
         Ok(())
@@ -524,7 +557,7 @@ impl NetworkManager {
                 let ack_num = new_tcp_socket.next_recv_seq();
 
                 let mut options = Vec::new();
-                let mss_bytes_len = 1460u16;
+                let mss_bytes_len = TcpSocket::RECV_MSS as u16;
                 options.push(0x02); // MSS
                 options.push(0x04); // MSS length
                 options.push((mss_bytes_len >> 8) as u8);
@@ -537,7 +570,7 @@ impl NetworkManager {
                     next_seq_num,
                     ack_num,
                     TcpPacket::FLAGS_SYN | TcpPacket::FLAGS_ACK,
-                    u16::MAX,
+                    new_tcp_socket.recv_window(),
                     0,
                     options,
                     Vec::new(),
@@ -561,7 +594,7 @@ impl NetworkManager {
                     next_seq_num,
                     ack_num,
                     TcpPacket::FLAGS_ACK,
-                    u16::MAX,
+                    socket_mut.recv_window(),
                     0,
                     Vec::new(),
                     Vec::new(),
@@ -605,7 +638,7 @@ impl NetworkManager {
                         next_seq_num,
                         ack_num,
                         TcpPacket::FLAGS_ACK,
-                        u16::MAX,
+                        socket_mut.recv_window(),
                         0,
                         Vec::new(),
                         Vec::new(),
@@ -880,6 +913,96 @@ pub fn create_new_socket(kind: SocketType) -> Result<SocketId> {
     NETWORK_MAN.try_lock()?.create_new_socket(kind)
 }
 
+pub fn is_socket_nonblock(socket_id: SocketId) -> Result<bool> {
+    Ok(NETWORK_MAN
+        .try_lock()?
+        .socket_table
+        .socket_by_id(socket_id)?
+        .nonblock())
+}
+
+pub fn set_socket_nonblock(socket_id: SocketId, nonblock: bool) -> Result<()> {
+    NETWORK_MAN
+        .try_lock()?
+        .socket_table
+        .socket_mut_by_id(socket_id)?
+        .set_nonblock(nonblock);
+    Ok(())
+}
+
+pub fn socket_rcv_buf_size(socket_id: SocketId) -> Result<usize> {
+    let mut man = NETWORK_MAN.try_lock()?;
+    let socket = man.socket_table.socket_mut_by_id(socket_id)?;
+    match socket.kind() {
+        SocketType::Stream => Ok(socket.inner_tcp_mut()?.rcv_buf_size()),
+        SocketType::Dgram => Ok(socket.inner_udp_mut()?.rcv_buf_size()),
+    }
+}
+
+pub fn set_socket_rcv_buf_size(socket_id: SocketId, size: usize) -> Result<()> {
+    let mut man = NETWORK_MAN.try_lock()?;
+    let socket = man.socket_table.socket_mut_by_id(socket_id)?;
+    match socket.kind() {
+        SocketType::Stream => socket.inner_tcp_mut()?.set_rcv_buf_size(size),
+        SocketType::Dgram => socket.inner_udp_mut()?.set_rcv_buf_size(size),
+    }
+    Ok(())
+}
+
+pub fn socket_snd_buf_size(socket_id: SocketId) -> Result<usize> {
+    Ok(NETWORK_MAN
+        .try_lock()?
+        .socket_table
+        .socket_by_id(socket_id)?
+        .snd_buf_size())
+}
+
+pub fn set_socket_snd_buf_size(socket_id: SocketId, size: usize) -> Result<()> {
+    NETWORK_MAN
+        .try_lock()?
+        .socket_table
+        .socket_mut_by_id(socket_id)?
+        .set_snd_buf_size(size);
+    Ok(())
+}
+
+pub fn tcp_nodelay(socket_id: SocketId) -> Result<bool> {
+    let mut man = NETWORK_MAN.try_lock()?;
+    let socket = man.socket_table.socket_mut_by_id(socket_id)?;
+    Ok(socket.inner_tcp_mut()?.nodelay())
+}
+
+pub fn set_tcp_nodelay(socket_id: SocketId, nodelay: bool) -> Result<()> {
+    let mut man = NETWORK_MAN.try_lock()?;
+    let socket = man.socket_table.socket_mut_by_id(socket_id)?;
+    socket.inner_tcp_mut()?.set_nodelay(nodelay);
+    Ok(())
+}
+
+pub fn set_socket_recv_ring(socket_id: SocketId, ring: RecvRing) -> Result<()> {
+    let mut man = NETWORK_MAN.try_lock()?;
+    let socket = man.socket_table.socket_mut_by_id(socket_id)?;
+    match socket.kind() {
+        SocketType::Stream => {
+            // a slot must fit any in-order segment (bounded by the
+            // advertised MSS) - a smaller slot would permanently stall
+            // the connection on the first full-sized segment
+            if (ring.slot_size() as usize) < TcpSocket::RECV_MSS {
+                return Err(Error::InvalidData.with_context("receive ring slot size"));
+            }
+            socket.inner_tcp_mut()?.set_recv_ring(ring)
+        }
+        SocketType::Dgram => socket.inner_udp_mut()?.set_recv_ring(ring),
+    }
+    Ok(())
+}
+
+pub fn tcp_recv_window(socket_id: SocketId) -> Result<u16> {
+    let mut man = NETWORK_MAN.try_lock()?;
+    let socket = man.socket_table.socket_mut_by_id(socket_id)?;
+    Ok(socket.inner_tcp_mut()?.recv_window())
+}
+
 pub fn bind_socket_v4(
     socket_id: SocketId,
     bound_addr: Option<Ipv4Addr>,
@@ -917,6 +1040,10 @@ pub fn accept_tcp_v4(socket_id: SocketId) -> Result<SocketId> {
     NETWORK_MAN.try_lock()?.accept_tcp_v4(socket_id)
 }
 
+pub fn is_socket_readable(socket_id: SocketId) -> Result<bool> {
+    NETWORK_MAN.try_lock()?.is_socket_readable(socket_id)
+}
+
 pub fn connect_tcp_v4(socket_id: SocketId, dst_addr: Ipv4Addr, dst_port: u16) -> Result<()> {
     NETWORK_MAN
         .try_lock()?
@@ -947,6 +1074,10 @@ pub fn send_tcp_syn(socket_id: SocketId) -> Result<()> {
 }
 
 pub fn send_tcp_packet(socket_id: SocketId, data: &[u8]) -> Result<()> {
+    send_tcp_data(socket_id, data.to_vec())
+}
+
+pub fn send_tcp_data(socket_id: SocketId, data: Vec<u8>) -> Result<()> {
     // pre-resolve MAC address
     let (dst_addr, _) = {
         let mut man = NETWORK_MAN.try_lock()?;
@@ -966,7 +1097,7 @@ pub fn send_tcp_packet(socket_id: SocketId, data: &[u8]) -> Result<()> {
     let target_ip = target_ip(my_ip, dst_addr);
     resolve_mac_addr(target_ip)?;
 
-    NETWORK_MAN.try_lock()?.send_tcp_packet(socket_id, data)
+    NETWORK_MAN.try_lock()?.send_tcp_data(socket_id, data)
 }
 
 pub fn recv_tcp_packet(socket_id: SocketId, buf: &mut [u8]) -> Result<usize> {
@@ -0,0 +1,116 @@
+use crate::{
+    arch::{x86_64::paging::PAGE_SIZE, VirtualAddress},
+    error::{Error, Result},
+    mem::bitmap::{self, MemoryFrame},
+};
+
+// shared single-producer (kernel) / single-consumer (app) packet ring,
+// mapped into the task by sys_recvring - the kernel delivers each
+// payload straight into a slot and the app consumes filled descriptors
+// without a copy into a socket queue or a syscall per packet.
+//
+// memory layout must match recv_ring in apps/libc/sys/socket.h:
+// head/tail/slot_size/slot_count header (4x u32), one u32 payload
+// length per slot, then slot_count fixed-size data slots
+#[derive(Debug)]
+pub struct RecvRing {
+    base_virt_addr: VirtualAddress,
+    slot_size: u32,
+    slot_count: u32,
+}
+
+const HEADER_LEN: usize = 16;
+const OFFSET_HEAD: usize = 0;
+const OFFSET_TAIL: usize = 4;
+const OFFSET_SLOT_SIZE: usize = 8;
+const OFFSET_SLOT_COUNT: usize = 12;
+
+impl RecvRing {
+    // the ring does not own its memory - the returned frame must be
+    // parked with the requesting task's other user allocations so it
+    // stays valid for as long as the task's mapping, even after the
+    // socket closes
+    pub fn new(slot_size: u32, slot_count: u32) -> Result<(Self, MemoryFrame)> {
+        if slot_size == 0 || slot_count == 0 {
+            return Err(Error::InvalidData.with_context("receive ring geometry"));
+        }
+
+        let len = HEADER_LEN
+            + slot_count as usize * size_of::<u32>()
+            + slot_size as usize * slot_count as usize;
+        let mem_frame = bitmap::alloc_mem_frame(len.div_ceil(PAGE_SIZE))?;
+        mem_frame.zero_out()?;
+
+        let base_virt_addr = mem_frame.frame_start_virt_addr();
+        let base = base_virt_addr.as_ptr_mut::<u8>();
+        unsafe {
+            (base.add(OFFSET_SLOT_SIZE) as *mut u32).write_volatile(slot_size);
+            (base.add(OFFSET_SLOT_COUNT) as *mut u32).write_volatile(slot_count);
+        }
+
+        let ring = Self {
+            base_virt_addr,
+            slot_size,
+            slot_count,
+        };
+        Ok((ring, mem_frame))
+    }
+
+    pub fn slot_size(&self) -> u32 {
+        self.slot_size
+    }
+
+    fn base(&self) -> *mut u8 {
+        self.base_virt_addr.as_ptr_mut()
+    }
+
+    fn filled_slots(&self) -> u32 {
+        let base = self.base();
+        let head = unsafe { (base.add(OFFSET_HEAD) as *const u32).read_volatile() };
+        let tail = unsafe { (base.add(OFFSET_TAIL) as *const u32).read_volatile() };
+        head.wrapping_sub(tail)
+    }
+
+    // true if the app still has slots to consume, used for poll
+    pub fn has_filled_slots(&self) -> bool {
+        self.filled_slots() > 0
+    }
+
+    // free ring capacity in bytes, used for the advertised TCP window
+    pub fn free_len(&self) -> usize {
+        let free_slots = self.slot_count.saturating_sub(self.filled_slots());
+        free_slots as usize * self.slot_size as usize
+    }
+
+    // delivers one packet payload into the next free slot; returns
+    // false (without consuming the data) when the ring is full or the
+    // payload does not fit a slot
+    pub fn push(&mut self, data: &[u8]) -> bool {
+        if data.len() > self.slot_size as usize {
+            return false;
+        }
+
+        if self.filled_slots() >= self.slot_count {
+            return false;
+        }
+
+        let base = self.base();
+        let head = unsafe { (base.add(OFFSET_HEAD) as *const u32).read_volatile() };
+        let index = (head % self.slot_count) as usize;
+
+        unsafe {
+            let len_ptr = base.add(HEADER_LEN + index * size_of::<u32>()) as *mut u32;
+            let slot_ptr = base.add(
+                HEADER_LEN
+                    + self.slot_count as usize * size_of::<u32>()
+                    + index * self.slot_size as usize,
+            );
+            slot_ptr.copy_from_nonoverlapping(data.as_ptr(), data.len());
+            len_ptr.write_volatile(data.len() as u32);
+            // publish the slot only after its contents are in place
+            (base.add(OFFSET_HEAD) as *mut u32).write_volatile(head.wrapping_add(1));
+        }
+
+        true
+    }
+}
@@ -60,13 +60,37 @@ pub struct Socket {
     pub addr: Option<Ipv4Addr>,
     inner: SocketInner,
     kind: SocketType,
+    // non-blocking receive/accept: the syscall layer returns EAGAIN
+    // instead of sleeping
+    nonblock: bool,
+    // SO_SNDBUF: sends are transmitted synchronously, so this caps how
+    // many bytes a single send accepts (callers see the short count)
+    snd_buf_size: usize,
 }
 
 impl Socket {
+    pub const DEFAULT_SND_BUF_SIZE: usize = 65536;
+
     pub fn port(&self) -> u16 {
         self.port
     }
 
+    pub fn snd_buf_size(&self) -> usize {
+        self.snd_buf_size
+    }
+
+    pub fn set_snd_buf_size(&mut self, size: usize) {
+        self.snd_buf_size = size;
+    }
+
+    pub fn nonblock(&self) -> bool {
+        self.nonblock
+    }
+
+    pub fn set_nonblock(&mut self, nonblock: bool) {
+        self.nonblock = nonblock;
+    }
+
     pub fn set_port(&mut self, port: u16) {
         self.port = port;
     }
@@ -183,6 +207,8 @@ impl SocketTable {
             addr: None, // unbound
             inner,
             kind,
+            nonblock: false,
+            snd_buf_size: Self::DEFAULT_SND_BUF_SIZE,
         };
         self.table.insert(id, socket);
 
@@ -1,7 +1,10 @@
 use crate::{
     error::{Error, Error_, Result},
     kdebug,
-    net::checksum::{checksum_words, fold_checksum, pseudo_header_sum},
+    net::{
+        checksum::{checksum_words, fold_checksum, pseudo_header_sum},
+        recv_ring::RecvRing,
+    },
 };
 use alloc::vec::Vec;
 use core::net::Ipv4Addr;
@@ -30,9 +33,22 @@ pub struct TcpSocket {
     seq_num: u32,
     next_recv_seq: u32,
     buf: Vec<u8>,
+    // SO_RCVBUF: bounds buf and determines the advertised window
+    rcv_buf_size: usize,
+    // TCP_NODELAY: this stack always transmits immediately, so the flag
+    // is only recorded for getsockopt and future coalescing
+    nodelay: bool,
+    // sys_recvring: when set, payloads bypass buf and are delivered
+    // straight into the mapped ring
+    recv_ring: Option<RecvRing>,
 }
 
 impl TcpSocket {
+    pub const DEFAULT_RCV_BUF_SIZE: usize = 65536;
+    // maximum segment size advertised in the SYN-ACK; bounds the
+    // payload of every in-order segment the peer may send
+    pub const RECV_MSS: usize = 1460;
+
     pub fn new() -> Self {
         Self {
             state: TcpSocketState::Closed,
@@ -42,6 +58,9 @@ impl TcpSocket {
             seq_num: 0,
             next_recv_seq: 0,
             buf: Vec::new(),
+            rcv_buf_size: Self::DEFAULT_RCV_BUF_SIZE,
+            nodelay: false,
+            recv_ring: None,
         }
     }
 
@@ -77,6 +96,43 @@ impl TcpSocket {
         self.next_recv_seq
     }
 
+    pub fn buf_len(&self) -> usize {
+        self.buf.len()
+    }
+
+    pub fn rcv_buf_size(&self) -> usize {
+        self.rcv_buf_size
+    }
+
+    pub fn set_rcv_buf_size(&mut self, size: usize) {
+        self.rcv_buf_size = size;
+    }
+
+    pub fn nodelay(&self) -> bool {
+        self.nodelay
+    }
+
+    pub fn set_nodelay(&mut self, nodelay: bool) {
+        self.nodelay = nodelay;
+    }
+
+    pub fn set_recv_ring(&mut self, ring: RecvRing) {
+        self.recv_ring = Some(ring);
+    }
+
+    pub fn recv_ring_readable(&self) -> bool {
+        matches!(&self.recv_ring, Some(ring) if ring.has_filled_slots())
+    }
+
+    // receive window advertised to the peer
+    pub fn recv_window(&self) -> u16 {
+        let avail = match &self.recv_ring {
+            Some(ring) => ring.free_len(),
+            None => self.rcv_buf_size.saturating_sub(self.buf.len()),
+        };
+        avail.min(u16::MAX as usize) as u16
+    }
+
     pub fn reset_buf(&mut self) -> Vec<u8> {
         let buf = self.buf.clone();
         self.buf = Vec::new();
@@ -169,6 +225,27 @@ impl TcpSocket {
         }
 
         if !data.is_empty() {
+            if let Some(ring) = &mut self.recv_ring {
+                // ring delivery: a full ring drops the segment without
+                // advancing next_recv_seq, so the peer retransmits once
+                // the app frees slots
+                if ring.push(data) {
+                    self.next_recv_seq = self.next_recv_seq.wrapping_add(data.len() as u32);
+                }
+                return Ok(());
+            }
+
+            // drop segments that would overflow the receive buffer
+            // without advancing next_recv_seq - the peer retransmits
+            // once the window reopens
+            if self.buf.len() + data.len() > self.rcv_buf_size {
+                kdebug!(
+                    "net: TCP receive buffer full: dropping {} bytes",
+                    data.len()
+                );
+                return Ok(());
+            }
+
             self.buf.extend_from_slice(data);
             self.next_recv_seq = self.next_recv_seq.wrapping_add(data.len() as u32);
         }
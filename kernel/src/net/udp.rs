@@ -1,6 +1,9 @@
 use crate::{
     error::Error,
-    net::checksum::{checksum_words, fold_checksum, pseudo_header_sum},
+    net::{
+        checksum::{checksum_words, fold_checksum, pseudo_header_sum},
+        recv_ring::RecvRing,
+    },
 };
 use alloc::{
     string::{String, ToString},
@@ -11,17 +14,58 @@ use core::net::Ipv4Addr;
 #[derive(Debug)]
 pub struct UdpSocket {
     buf: Vec<u8>,
+    // SO_RCVBUF: datagrams that would overflow buf are dropped
+    rcv_buf_size: usize,
+    // sys_recvring: when set, datagrams bypass buf and are delivered
+    // straight into the mapped ring
+    recv_ring: Option<RecvRing>,
 }
 
 impl UdpSocket {
+    pub const DEFAULT_RCV_BUF_SIZE: usize = 65536;
+
     pub fn new() -> Self {
-        Self { buf: Vec::new() }
+        Self {
+            buf: Vec::new(),
+            rcv_buf_size: Self::DEFAULT_RCV_BUF_SIZE,
+            recv_ring: None,
+        }
     }
 
     pub fn receive(&mut self, data: &[u8]) {
+        if let Some(ring) = &mut self.recv_ring {
+            // full ring or oversized datagram: dropped, like UDP does
+            let _ = ring.push(data);
+            return;
+        }
+
+        if self.buf.len() + data.len() > self.rcv_buf_size {
+            return;
+        }
+
         self.buf.extend_from_slice(data);
     }
 
+    pub fn set_recv_ring(&mut self, ring: RecvRing) {
+        self.recv_ring = Some(ring);
+    }
+
+    pub fn recv_ring_readable(&self) -> bool {
+        matches!(&self.recv_ring, Some(ring) if ring.has_filled_slots())
+    }
+
+    pub fn rcv_buf_size(&self) -> usize {
+        self.rcv_buf_size
+    }
+
+    pub fn set_rcv_buf_size(&mut self, size: usize) {
+        self.rcv_buf_size = size;
+    }
+
+    pub fn buf_len(&self) -> usize {
+        self.buf.len()
+    }
+
     pub fn buf_to_string_utf8_lossy(&self) -> String {
         String::from_utf8_lossy(&self.buf).to_string()
     }
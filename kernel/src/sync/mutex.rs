@@ -4,6 +4,7 @@ use crate::{
 };
 use core::{
     cell::SyncUnsafeCell,
+    fmt,
     ops::{Deref, DerefMut},
     sync::atomic::{AtomicBool, Ordering},
 };
@@ -13,6 +14,13 @@ pub struct Mutex<T> {
     locked: AtomicBool,
 }
 
+// the inner value cannot be read without locking, so just mark it
+impl<T> fmt::Debug for Mutex<T> {
+    fn fmt(&self, f: &mut fmt::Formatter<'_>) -> fmt::Result {
+        write!(f, "Mutex {{ .. }}")
+    }
+}
+
 impl<T: Sized> Mutex<T> {
     pub const fn new(value: T) -> Self {
         Self {
@@ -6,25 +6,69 @@ use crate::{
         vfs::{self, FileDescriptorNumber},
     },
     kerror,
+    sync::mutex::Mutex,
     task::TaskId,
 };
+use alloc::{collections::btree_map::BTreeMap, string::String, sync::Arc, vec::Vec};
 use common::elf::Elf64;
 
+// raw ELF images keyed by absolute path, so repeated launches of the
+// same binary skip the filesystem read; the fs carries no mtime, so a
+// cached entry is revalidated against the current file size instead
+const ELF_CACHE_MAX_BYTES: usize = 4 * 1024 * 1024;
+static ELF_CACHE: Mutex<BTreeMap<String, Arc<Vec<u8>>>> = Mutex::new(BTreeMap::new());
+
+fn elf_cache_key(elf_path: &Path) -> Result<String> {
+    let abs_path = if elf_path.is_abs() {
+        elf_path.normalize()
+    } else {
+        vfs::cwd_path()?.join(elf_path.as_str()).normalize()
+    };
+    Ok(abs_path.to_string())
+}
+
+fn elf_image(elf_path: &Path) -> Result<Arc<Vec<u8>>> {
+    let key = elf_cache_key(elf_path)?;
+    let fd_num = vfs::open_file(elf_path, false)?;
+    let size = vfs::file_size(fd_num)?;
+
+    if let Some(cached) = ELF_CACHE.try_lock()?.get(&key) {
+        if cached.len() == size {
+            vfs::close_file(fd_num)?;
+            return Ok(cached.clone());
+        }
+    }
+
+    let elf_data = Arc::new(vfs::read_file(fd_num, usize::MAX)?);
+    vfs::close_file(fd_num)?;
+
+    if elf_data.len() <= ELF_CACHE_MAX_BYTES {
+        let mut cache = ELF_CACHE.try_lock()?;
+        let mut total: usize = cache.values().map(|data| data.len()).sum();
+        while total + elf_data.len() > ELF_CACHE_MAX_BYTES {
+            match cache.pop_first() {
+                Some((_, evicted)) => total -= evicted.len(),
+                None => break,
+            }
+        }
+        cache.insert(key, elf_data.clone());
+    }
+
+    Ok(elf_data)
+}
+
 pub fn exec_elf(
     elf_path: &Path,
     args: &[&str],
     enable_debug: bool,
     pipe_fd: [Option<FileDescriptorNumber>; 3],
 ) -> Result<TaskId> {
-    let fd_num = vfs::open_file(elf_path, false)?;
-    let elf_data = vfs::read_file(fd_num, usize::MAX)?;
+    let elf_data = elf_image(elf_path)?;
     let elf64 = match Elf64::new(&elf_data) {
         Ok(e) => e,
         Err(err) => return Err(err.into()),
     };
 
-    vfs::close_file(fd_num)?;
-
     let dwarf = if enable_debug {
         match dwarf::parse(&elf64) {
             Ok(d) => Some(d),
@@ -37,5 +81,5 @@ pub fn exec_elf(
         None
     };
 
-    super::scheduler::spawn_user_task(elf64, elf_path, args, dwarf, pipe_fd)
+    super::scheduler::spawn_user_task(elf_data, elf_path, args, dwarf, pipe_fd)
 }
@@ -16,9 +16,10 @@ use crate::{
     graphics::{multi_layer::LayerId, window_manager},
     kdebug,
     mem::bitmap::{self, MemoryFrame},
+    sync::mutex::Mutex,
     util,
 };
-use alloc::{string::String, vec::Vec};
+use alloc::{string::String, sync::Arc, vec::Vec};
 use common::elf::{self, Elf64};
 use core::{
     fmt,
@@ -28,6 +29,7 @@ use core::{
 pub mod async_task;
 pub mod exec;
 pub mod scheduler;
+pub mod shm;
 pub mod syscall;
 
 pub const USER_TASK_STACK_SIZE: usize = 1024 * 1024; // 1MiB
@@ -60,13 +62,53 @@ impl From<usize> for TaskId {
     }
 }
 
+// a PT_LOAD segment whose pages are mapped and filled on first fault
+// instead of being copied up front
+#[derive(Debug, Clone, Copy)]
+struct LazySegment {
+    virt_addr: u64,
+    mem_size: u64,
+    file_size: u64,
+    file_offset: u64,
+}
+
+// everything the tasks of one process share: threads created with
+// sys_thread_create hold an Arc to the creator's address space, which
+// is torn down when the last task referencing it exits
 #[derive(Debug)]
-struct TaskResource {
+struct AddressSpace {
     page_table: UserPageTable,
-    args_frame: Option<MemoryFrame>,
-    stack_frame: Option<MemoryFrame>,
+    // the raw ELF image backing the lazy segments; shared with the exec
+    // cache, so holding it here costs no extra copy
+    elf_image: Option<Arc<Vec<u8>>>,
+    lazy_segments: Vec<LazySegment>,
     program_frames: Vec<MemoryFrame>,
     alloc_frames: Vec<MemoryFrame>,
+    // shared memory segments this space references
+    shm_ids: Vec<u32>,
+}
+
+impl Drop for AddressSpace {
+    fn drop(&mut self) {
+        for frame in self.program_frames.drain(..) {
+            bitmap::dealloc_mem_frame(frame).unwrap();
+        }
+
+        for frame in self.alloc_frames.drain(..) {
+            bitmap::dealloc_mem_frame(frame).unwrap();
+        }
+
+        for shm_id in self.shm_ids.drain(..) {
+            shm::unref(shm_id).unwrap();
+        }
+    }
+}
+
+#[derive(Debug)]
+struct TaskResource {
+    addr_space: Arc<Mutex<AddressSpace>>,
+    args_frame: Option<MemoryFrame>,
+    stack_frame: Option<MemoryFrame>,
     created_layer_ids: Vec<LayerId>,
     fd_nums: Vec<FileDescriptorNumber>,
     pipe_fd: [Option<FileDescriptorNumber>; 3],
@@ -79,17 +121,18 @@ impl Drop for TaskResource {
         }
 
         if let Some(stack_frame) = self.stack_frame.take() {
+            // a thread's stack lives in an address space shared with its
+            // siblings, so unmap it before freeing the frame (same order
+            // as sys_free) - otherwise the survivors keep a writable
+            // mapping of memory the allocator may hand out again
+            let start: VirtualAddress = stack_frame.frame_start_phys_addr().into();
+            let end = start.offset(stack_frame.frame_size());
+            unsafe {
+                self.addr_space.spin_lock().page_table.unmap(start, end);
+            }
             bitmap::dealloc_mem_frame(stack_frame).unwrap();
         }
 
-        for frame in self.program_frames.drain(..) {
-            bitmap::dealloc_mem_frame(frame).unwrap();
-        }
-
-        for frame in self.alloc_frames.drain(..) {
-            bitmap::dealloc_mem_frame(frame).unwrap();
-        }
-
         // destroy all created windows
         for layer_id in self.created_layer_ids.iter() {
             let _ = window_manager::remove_component(*layer_id);
@@ -104,18 +147,15 @@ impl Drop for TaskResource {
 
 impl TaskResource {
     fn new(
-        page_table: UserPageTable,
+        addr_space: Arc<Mutex<AddressSpace>>,
         args_frame: Option<MemoryFrame>,
         stack_frame: Option<MemoryFrame>,
-        program_frames: Vec<MemoryFrame>,
         pipe_fd: [Option<FileDescriptorNumber>; 3],
     ) -> Self {
         Self {
-            page_table,
+            addr_space,
             args_frame,
             stack_frame,
-            program_frames,
-            alloc_frames: Vec::new(),
             created_layer_ids: Vec::new(),
             fd_nums: Vec::new(),
             pipe_fd,
@@ -153,6 +193,10 @@ pub struct TaskSnapshot {
     pub name: String,
     pub state: TaskState,
     pub parent: Option<TaskId>,
+    pub cpu_time_ms: u64,
+    pub ctx_switches: u64,
+    pub syscall_count: u64,
+    pub heap_bytes: u64,
 }
 
 #[derive(Debug)]
@@ -166,6 +210,10 @@ struct Task {
     waiting_for: Option<TaskId>,
     parent: Option<TaskId>,
     children: Vec<TaskId>,
+    // accounting published through /proc/stat
+    cpu_time_ms: u64,
+    ctx_switches: u64,
+    syscall_count: u64,
 }
 
 impl Drop for Task {
@@ -178,7 +226,7 @@ impl Task {
     fn new(
         parent: Option<TaskId>,
         stack_size: usize, // 4KiB align
-        elf64: Option<Elf64>,
+        elf_image: Option<Arc<Vec<u8>>>,
         args: Option<&[&str]>, // file name + args
         mode: ContextMode,
         dwarf: Option<Dwarf>,
@@ -189,10 +237,16 @@ impl Task {
             ContextMode::Kernel => UserPageTable::new()?,
         };
 
-        // parse ELF
+        // parse ELF; segments are not copied here - they are recorded
+        // and mapped page by page on first fault, so exec cost tracks
+        // pages actually touched rather than binary size
         let mut entry = None;
-        let mut program_frames = Vec::new();
-        if let Some(elf64) = elf64 {
+        let mut lazy_segments = Vec::new();
+        if let Some(elf_image) = elf_image.as_ref() {
+            let elf64 = match Elf64::new(elf_image) {
+                Ok(e) => e,
+                Err(err) => return Err(err.into()),
+            };
             let header = elf64.header();
 
             if header.elf_type() != elf::Type::Executable {
@@ -210,38 +264,13 @@ impl Task {
 
                 let p_virt_addr = program_header.virt_addr;
                 let p_mem_size = program_header.mem_size;
-                let p_file_size = program_header.file_size;
-
-                let pages_needed =
-                    ((p_virt_addr % PAGE_SIZE as u64 + p_mem_size + PAGE_SIZE as u64 - 1)
-                        / PAGE_SIZE as u64) as usize;
-                let user_mem_frame = bitmap::alloc_mem_frame(pages_needed)?;
-                user_mem_frame.zero_out()?;
-                let user_mem_frame_start_virt_addr = user_mem_frame.frame_start_virt_addr();
-
-                // copy data
-                let program_data = elf64.data_by_program_header(program_header);
-                if let Some(data) = program_data {
-                    unsafe {
-                        user_mem_frame_start_virt_addr
-                            .offset(p_virt_addr as usize % PAGE_SIZE)
-                            .as_ptr_mut::<u8>()
-                            .copy_from_nonoverlapping(data.as_ptr(), p_file_size as usize);
-                    }
-                }
 
-                // map into user page table at ELF virtual address
-                let start_virt_addr: VirtualAddress =
-                    (p_virt_addr / PAGE_SIZE as u64 * PAGE_SIZE as u64).into();
-                user_page_table.map(
-                    start_virt_addr,
-                    start_virt_addr.offset(user_mem_frame.frame_size()),
-                    user_mem_frame.frame_start_phys_addr(),
-                    ReadWrite::Write,
-                    PageWriteThroughLevel::WriteThrough,
-                    false,
-                )?;
-                program_frames.push(user_mem_frame);
+                lazy_segments.push(LazySegment {
+                    virt_addr: p_virt_addr,
+                    mem_size: p_mem_size,
+                    file_size: program_header.file_size,
+                    file_offset: program_header.offset,
+                });
 
                 if header.entry_point >= p_virt_addr
                     && header.entry_point < p_virt_addr + p_mem_size
@@ -345,25 +374,141 @@ impl Task {
         context.init(rip, arg0, arg1, rsp, mode, dwarf.is_some());
         context.cr3 = cr3;
 
+        let addr_space = Arc::new(Mutex::new(AddressSpace {
+            page_table: user_page_table,
+            elf_image,
+            lazy_segments,
+            program_frames: Vec::new(),
+            alloc_frames: Vec::new(),
+            shm_ids: Vec::new(),
+        }));
+
         Ok(Self {
             id: TaskId::new(),
             name,
             state: TaskState::default(),
             context,
-            resource: TaskResource::new(
-                user_page_table,
-                args_frame,
-                stack_frame,
-                program_frames,
-                pipe_fd,
-            ),
+            resource: TaskResource::new(addr_space, args_frame, stack_frame, pipe_fd),
             dwarf,
             waiting_for: None,
             parent,
             children: Vec::new(),
+            cpu_time_ms: 0,
+            ctx_switches: 0,
+            syscall_count: 0,
         })
     }
 
+    // a thread: its own stack and context, everything else shared with
+    // the parent through the address space
+    fn new_thread(parent: &Task, entry: u64, arg: u64, stack_size: usize) -> Result<Self> {
+        let addr_space = parent.resource.addr_space.clone();
+
+        let stack_frame = bitmap::alloc_mem_frame(stack_size.div_ceil(PAGE_SIZE).max(1))?;
+        {
+            let mut space = addr_space.spin_lock();
+            let phys = stack_frame.frame_start_phys_addr();
+            let start: VirtualAddress = phys.into();
+            space.page_table.map(
+                start,
+                start.offset(stack_frame.frame_size()),
+                phys,
+                ReadWrite::Write,
+                PageWriteThroughLevel::WriteThrough,
+                false,
+            )?;
+        }
+
+        let rsp = (stack_frame.frame_start_virt_addr().get() + stack_size as u64 - 63) & !63;
+        assert!(rsp % 64 == 0);
+
+        let mut context = Context::new();
+        context.init(entry, arg, 0, rsp, ContextMode::User, false);
+        context.cr3 = parent.context.cr3;
+
+        Ok(Self {
+            id: TaskId::new(),
+            name: parent.name.clone(),
+            state: TaskState::default(),
+            context,
+            resource: TaskResource::new(
+                addr_space,
+                None,
+                Some(stack_frame),
+                parent.resource.pipe_fd,
+            ),
+            dwarf: None,
+            waiting_for: None,
+            parent: Some(parent.id),
+            children: Vec::new(),
+            cpu_time_ms: 0,
+            ctx_switches: 0,
+            syscall_count: 0,
+        })
+    }
+
+    // back the faulting page with a fresh zeroed frame, fill it from
+    // every segment overlapping the page (file bytes where the segment
+    // has them, zeros for .bss) and map it; Err if the address is not
+    // inside a lazily loaded segment
+    fn demand_map_elf_page(&mut self, virt_addr: VirtualAddress) -> Result<()> {
+        let mut space = self.resource.addr_space.spin_lock();
+        let elf_image = space
+            .elf_image
+            .clone()
+            .ok_or(Error::NotFound.with_context("ELF image"))?;
+
+        let page_start = virt_addr.get() & !(PAGE_SIZE as u64 - 1);
+        let page_end = page_start + PAGE_SIZE as u64;
+
+        let overlapping: Vec<LazySegment> = space
+            .lazy_segments
+            .iter()
+            .filter(|seg| seg.virt_addr < page_end && page_start < seg.virt_addr + seg.mem_size)
+            .copied()
+            .collect();
+        if overlapping.is_empty() {
+            return Err(Error::NotFound.with_context("demand-paged segment"));
+        }
+
+        let frame = bitmap::alloc_mem_frame(1)?;
+        frame.zero_out()?;
+        let frame_virt_addr = frame.frame_start_virt_addr();
+
+        for seg in &overlapping {
+            let copy_start = page_start.max(seg.virt_addr);
+            let copy_end = page_end.min(seg.virt_addr + seg.file_size);
+            if copy_start >= copy_end {
+                continue;
+            }
+
+            let src_offset = (seg.file_offset + (copy_start - seg.virt_addr)) as usize;
+            let copy_len = (copy_end - copy_start) as usize;
+            if src_offset + copy_len > elf_image.len() {
+                return Err(Error::InvalidData.with_context("ELF segment bounds"));
+            }
+
+            unsafe {
+                frame_virt_addr
+                    .offset((copy_start - page_start) as usize)
+                    .as_ptr_mut::<u8>()
+                    .copy_from_nonoverlapping(elf_image[src_offset..].as_ptr(), copy_len);
+            }
+        }
+
+        space.page_table.map(
+            page_start.into(),
+            page_end.into(),
+            frame.frame_start_phys_addr(),
+            ReadWrite::Write,
+            PageWriteThroughLevel::WriteThrough,
+            false,
+        )?;
+        space.program_frames.push(frame);
+
+        Ok(())
+    }
+
     fn switch_to(&self, next_task: &Task) {
         // kdebug!("task: Switch context tid: {} to {}", self.id, next_task.id);
 
@@ -19,6 +19,7 @@ use alloc::{
     boxed::Box,
     collections::{btree_map::BTreeMap, vec_deque::VecDeque},
     string::ToString,
+    sync::Arc,
     vec::Vec,
 };
 
@@ -94,6 +95,7 @@ impl TaskScheduler {
         if let Some(mut next_task) = self.ready_queue.pop_front() {
             prev_task.state = TaskState::Ready;
             next_task.state = TaskState::Running;
+            next_task.ctx_switches += 1;
 
             self.ready_queue.push_back(prev_task);
             self.current_task = Some(next_task);
@@ -153,6 +155,7 @@ impl TaskScheduler {
             .pop_front()
             .expect("No task to run after exit");
         next_task.state = TaskState::Running;
+        next_task.ctx_switches += 1;
         self.current_task = Some(next_task);
 
         let prev_ptr = &**self.exited_tasks.last().unwrap() as *const Task;
@@ -172,6 +175,7 @@ impl TaskScheduler {
             .pop_front()
             .expect("No task to run after sleep");
         next_task.state = TaskState::Running;
+        next_task.ctx_switches += 1;
         self.current_task = Some(next_task);
 
         let prev_ptr = &**self.sleeping_tasks.last().unwrap() as *const Task;
@@ -208,7 +212,7 @@ pub fn init() -> Result<()> {
 }
 
 pub fn spawn_user_task(
-    elf64: Elf64,
+    elf_image: Arc<Vec<u8>>,
     path: &Path,
     args: &[&str],
     dwarf: Option<Dwarf>,
@@ -220,7 +224,7 @@ pub fn spawn_user_task(
     let task = Task::new(
         Some(parent_id),
         super::USER_TASK_STACK_SIZE,
-        Some(elf64),
+        Some(elf_image),
         Some(&all_args),
         ContextMode::User,
         dwarf,
@@ -235,6 +239,21 @@ pub fn spawn_user_task(
     Ok(id)
 }
 
+// spawn a thread of the current task - a new task sharing the caller's
+// address space, entering at entry with arg in the first argument register
+pub fn spawn_thread(entry: u64, arg: u64) -> Result<TaskId> {
+    let mut s = TASK_SCHED.spin_lock();
+    let task = {
+        let parent = s.current_task_mut()?;
+        Task::new_thread(parent, entry, arg, super::USER_TASK_STACK_SIZE)?
+    };
+    let id = task.id;
+    s.spawn(task);
+    s.current_task_mut()?.children.push(id);
+
+    Ok(id)
+}
+
 pub fn sleep_waiting_for(child_id: TaskId) {
     let saved = Rflags::read_with_cli();
     let pair = TASK_SCHED
@@ -291,6 +310,10 @@ pub fn take_exit_code(id: TaskId) -> Option<i32> {
     TASK_SCHED.spin_lock().exit_codes.remove(&id)
 }
 
+pub fn has_exit_code(id: TaskId) -> bool {
+    TASK_SCHED.spin_lock().exit_codes.contains_key(&id)
+}
+
 pub fn current_add_layer_id(layer_id: LayerId) -> Result<()> {
     let mut s = TASK_SCHED.spin_lock();
     s.current_task_mut()?
@@ -326,7 +349,12 @@ pub fn current_remove_fd(fd_num: FileDescriptorNumber) -> Result<()> {
 
 pub fn current_add_mem_frame(mem_frame: MemoryFrame) -> Result<()> {
     let mut s = TASK_SCHED.spin_lock();
-    s.current_task_mut()?.resource.alloc_frames.push(mem_frame);
+    s.current_task_mut()?
+        .resource
+        .addr_space
+        .spin_lock()
+        .alloc_frames
+        .push(mem_frame);
     Ok(())
 }
 
@@ -336,7 +364,7 @@ pub fn current_map_user_page(frame: &MemoryFrame) -> Result<()> {
     let phys = frame.frame_start_phys_addr();
     let start: VirtualAddress = phys.into();
     let end = start.offset(frame.frame_size());
-    task.resource.page_table.map(
+    task.resource.addr_space.spin_lock().page_table.map(
         start,
         end,
         phys,
@@ -347,19 +375,90 @@ pub fn current_map_user_page(frame: &MemoryFrame) -> Result<()> {
     Ok(())
 }
 
+pub fn current_map_user_page_readonly(frame: &MemoryFrame) -> Result<()> {
+    let mut s = TASK_SCHED.spin_lock();
+    let task = s.current_task_mut()?;
+    let phys = frame.frame_start_phys_addr();
+    let start: VirtualAddress = phys.into();
+    let end = start.offset(frame.frame_size());
+    task.resource.addr_space.spin_lock().page_table.map(
+        start,
+        end,
+        phys,
+        ReadWrite::Read,
+        PageWriteThroughLevel::WriteThrough,
+        false,
+    )?;
+    Ok(())
+}
+
 pub fn current_unmap_user_page(frame: &MemoryFrame) -> Result<()> {
     let mut s = TASK_SCHED.spin_lock();
     let task = s.current_task_mut()?;
     let start: VirtualAddress = frame.frame_start_phys_addr().into();
     let end = start.offset(frame.frame_size());
-    unsafe { task.resource.page_table.unmap(start, end) };
+    unsafe {
+        task.resource
+            .addr_space
+            .spin_lock()
+            .page_table
+            .unmap(start, end)
+    };
     Ok(())
 }
 
+// create a shared memory segment owned by the current task's address
+// space; the segment is mapped on demand through current_map_shm
+pub fn current_create_shm(size: usize) -> Result<u32> {
+    let shm_id = super::shm::create(size)?;
+
+    let mut s = TASK_SCHED.spin_lock();
+    let task = match s.current_task_mut() {
+        Ok(task) => task,
+        Err(err) => {
+            super::shm::unref(shm_id)?;
+            return Err(err);
+        }
+    };
+    task.resource.addr_space.spin_lock().shm_ids.push(shm_id);
+
+    Ok(shm_id)
+}
+
+// map a shared memory segment into the current task's address space and
+// return its start address, taking a reference on first map
+pub fn current_map_shm(shm_id: u32) -> Result<VirtualAddress> {
+    let mut s = TASK_SCHED.spin_lock();
+    let task = s.current_task_mut()?;
+    let mut space = task.resource.addr_space.spin_lock();
+
+    let (phys, size) = if space.shm_ids.contains(&shm_id) {
+        // our own reference keeps the segment alive
+        super::shm::segment_info(shm_id)?
+    } else {
+        let info = super::shm::add_ref(shm_id)?;
+        space.shm_ids.push(shm_id);
+        info
+    };
+
+    let start: VirtualAddress = phys.into();
+    space.page_table.map(
+        start,
+        start.offset(size),
+        phys,
+        ReadWrite::Write,
+        PageWriteThroughLevel::WriteThrough,
+        false,
+    )?;
+
+    Ok(start)
+}
+
 pub fn current_mem_frame_size(virt_addr: VirtualAddress) -> Result<Option<usize>> {
     let mut s = TASK_SCHED.spin_lock();
     let task = s.current_task_mut()?;
-    for mem_frame in &task.resource.alloc_frames {
+    let space = task.resource.addr_space.spin_lock();
+    for mem_frame in &space.alloc_frames {
         if mem_frame.frame_start_virt_addr() == virt_addr {
             return Ok(Some(mem_frame.frame_size()));
         }
@@ -369,7 +468,8 @@ pub fn current_mem_frame_size(virt_addr: VirtualAddress) -> Result<Option<usize>
 
 pub fn current_remove_mem_frame(virt_addr: VirtualAddress) -> Result<MemoryFrame> {
     let mut s = TASK_SCHED.spin_lock();
-    let allocated = &mut s.current_task_mut()?.resource.alloc_frames;
+    let mut space = s.current_task_mut()?.resource.addr_space.spin_lock();
+    let allocated = &mut space.alloc_frames;
     if let Some(index) = allocated
         .iter()
         .position(|info| info.frame_start_virt_addr() == virt_addr)
@@ -379,6 +479,15 @@ pub fn current_remove_mem_frame(virt_addr: VirtualAddress) -> Result<MemoryFrame
     Err(Error::InvalidData.with_context("virtual address"))
 }
 
+// map one demand-paged ELF page for the current task; Err if the
+// address does not fall inside a lazily loaded segment
+pub fn demand_page(virt_addr: VirtualAddress) -> Result<()> {
+    TASK_SCHED
+        .spin_lock()
+        .current_task_mut()?
+        .demand_map_elf_page(virt_addr)
+}
+
 pub fn current_debug_print() -> bool {
     let s = TASK_SCHED.spin_lock();
     if let Some(task) = s.current_task.as_ref() {
@@ -404,6 +513,10 @@ pub fn preempt_sched(interrupted: &InterruptedContext) -> *const Context {
         let mut s = TASK_SCHED.spin_lock();
 
         if let Some(current) = s.current_task.as_mut() {
+            // the preemption timer fires once per interval, so charge the
+            // interrupted task one interval of CPU time
+            current.cpu_time_ms += crate::device::local_apic_timer::INT_INTERVAL_MS as u64;
+
             let ctx = &mut current.context;
             ctx.rip = interrupted.rip;
             ctx.rflags.set_raw(interrupted.rflags);
@@ -478,14 +591,56 @@ pub fn task_ids() -> Vec<TaskId> {
     ids
 }
 
+fn snapshot_of(task: &Task) -> TaskSnapshot {
+    let heap_bytes: usize = task
+        .resource
+        .addr_space
+        .spin_lock()
+        .alloc_frames
+        .iter()
+        .map(|f| f.frame_size())
+        .sum();
+
+    TaskSnapshot {
+        id: task.id,
+        name: task.name.clone(),
+        state: task.state,
+        parent: task.parent,
+        cpu_time_ms: task.cpu_time_ms,
+        ctx_switches: task.ctx_switches,
+        syscall_count: task.syscall_count,
+        heap_bytes: heap_bytes as u64,
+    }
+}
+
 pub fn task_snapshot(id: TaskId) -> Option<TaskSnapshot> {
     let s = TASK_SCHED.spin_lock();
-    s.find_task(id).map(|t| TaskSnapshot {
-        id: t.id,
-        name: t.name.clone(),
-        state: t.state,
-        parent: t.parent,
-    })
+    s.find_task(id).map(snapshot_of)
+}
+
+// all tasks in one pass under a single lock, for /proc/stat
+pub fn task_snapshots() -> Vec<TaskSnapshot> {
+    let s = TASK_SCHED.spin_lock();
+    let mut snapshots = Vec::new();
+
+    if let Some(task) = s.current_task.as_deref() {
+        snapshots.push(snapshot_of(task));
+    }
+    for task in &s.ready_queue {
+        snapshots.push(snapshot_of(task));
+    }
+    for task in &s.sleeping_tasks {
+        snapshots.push(snapshot_of(task));
+    }
+
+    snapshots
+}
+
+// one increment per syscall entry, published through /proc/stat
+pub fn current_count_syscall() {
+    if let Ok(task) = TASK_SCHED.spin_lock().current_task_mut() {
+        task.syscall_count += 1;
+    }
 }
 
 #[test_case]
@@ -0,0 +1,92 @@
+use crate::{
+    arch::x86_64::paging::PAGE_SIZE,
+    error::{Error, Result},
+    mem::bitmap::{self, MemoryFrame},
+    sync::mutex::Mutex,
+};
+use alloc::collections::btree_map::BTreeMap;
+use core::sync::atomic::{AtomicU32, Ordering};
+
+// shared memory segments for zero-copy IPC: cooperating tasks map the
+// same frames and exchange bulk data through them, keeping only small
+// control messages on the pipe. A segment is reference counted per
+// address space and freed when the last space holding it is torn down.
+#[derive(Debug)]
+struct ShmSegment {
+    frame: MemoryFrame,
+    ref_count: usize,
+}
+
+static SHM_SEGMENTS: Mutex<BTreeMap<u32, ShmSegment>> = Mutex::new(BTreeMap::new());
+
+// ids start at 1 so 0 never names a segment on the user side
+fn next_id() -> u32 {
+    static NEXT: AtomicU32 = AtomicU32::new(1);
+    NEXT.fetch_add(1, Ordering::Relaxed)
+}
+
+// allocate a zeroed segment; the initial reference belongs to the
+// creator's address space
+pub fn create(size: usize) -> Result<u32> {
+    if size == 0 {
+        return Err(Error::InvalidData.with_context("shared memory size"));
+    }
+
+    let frame = bitmap::alloc_mem_frame(size.div_ceil(PAGE_SIZE))?;
+    frame.zero_out()?;
+
+    let id = next_id();
+    SHM_SEGMENTS.spin_lock().insert(
+        id,
+        ShmSegment {
+            frame,
+            ref_count: 1,
+        },
+    );
+
+    Ok(id)
+}
+
+// take a new reference; returns the segment's physical start and size
+pub fn add_ref(id: u32) -> Result<(u64, usize)> {
+    let mut segments = SHM_SEGMENTS.spin_lock();
+    let segment = segments
+        .get_mut(&id)
+        .ok_or(Error::NotFound.with_context("shared memory segment"))?;
+    segment.ref_count += 1;
+
+    Ok((
+        segment.frame.frame_start_phys_addr(),
+        segment.frame.frame_size(),
+    ))
+}
+
+// look up without taking a reference - only safe while the caller's
+// address space already holds one
+pub fn segment_info(id: u32) -> Result<(u64, usize)> {
+    let segments = SHM_SEGMENTS.spin_lock();
+    let segment = segments
+        .get(&id)
+        .ok_or(Error::NotFound.with_context("shared memory segment"))?;
+
+    Ok((
+        segment.frame.frame_start_phys_addr(),
+        segment.frame.frame_size(),
+    ))
+}
+
+// drop one reference, freeing the segment when the last one goes away
+pub fn unref(id: u32) -> Result<()> {
+    let mut segments = SHM_SEGMENTS.spin_lock();
+    let segment = segments
+        .get_mut(&id)
+        .ok_or(Error::NotFound.with_context("shared memory segment"))?;
+    segment.ref_count -= 1;
+
+    if segment.ref_count == 0 {
+        let segment = segments.remove(&id).unwrap();
+        bitmap::dealloc_mem_frame(segment.frame)?;
+    }
+
+    Ok(())
+}
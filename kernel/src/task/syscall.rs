@@ -3,7 +3,8 @@ use crate::{
         x86_64::{self, gdt::*, paging::PAGE_SIZE, registers::*},
         VirtualAddress,
     },
-    device::tty,
+    debug,
+    device::{input_event, local_apic_timer, tty},
     env,
     error::{Error, Result},
     fs::{
@@ -23,7 +24,7 @@ use alloc::{
     string::{String, ToString},
     vec::Vec,
 };
-use common::geometry::{Point, Size};
+use common::geometry::{Point, Rect, Size};
 use core::{arch::naked_asm, net::Ipv4Addr, slice};
 use libc_rs::*;
 
@@ -33,6 +34,9 @@ enum IomsgCommand {
     RemoveComponent = IOMSG_CMD_REMOVE_COMPONENT,
     CreateComponentWindow = IOMSG_CMD_CREATE_COMPONENT_WINDOW,
     CreateComponentImage = IOMSG_CMD_CREATE_COMPONENT_IMAGE,
+    FlushComponentImage = IOMSG_CMD_FLUSH_COMPONENT_IMAGE,
+    FlipComponentImage = IOMSG_CMD_FLIP_COMPONENT_IMAGE,
+    SubscribeInput = IOMSG_CMD_SUBSCRIBE_INPUT,
 }
 
 trait IomsgHeaderExt {
@@ -58,6 +62,9 @@ impl IomsgHeaderExt for iomsg_header {
             IOMSG_CMD_REMOVE_COMPONENT => Ok(IomsgCommand::RemoveComponent),
             IOMSG_CMD_CREATE_COMPONENT_WINDOW => Ok(IomsgCommand::CreateComponentWindow),
             IOMSG_CMD_CREATE_COMPONENT_IMAGE => Ok(IomsgCommand::CreateComponentImage),
+            IOMSG_CMD_FLUSH_COMPONENT_IMAGE => Ok(IomsgCommand::FlushComponentImage),
+            IOMSG_CMD_FLIP_COMPONENT_IMAGE => Ok(IomsgCommand::FlipComponentImage),
+            IOMSG_CMD_SUBSCRIBE_INPUT => Ok(IomsgCommand::SubscribeInput),
             _ => Err(Error::InvalidData.with_context("syscall command ID")),
         }
     }
@@ -105,6 +112,7 @@ extern "sysv64" fn syscall_handler(
     arg5: u64,        // (sysv abi) r9
 ) -> i64 /* rax */ {
     tty::check_sigint();
+    task::scheduler::current_count_syscall();
 
     let result = syscall_handler_inner(syscall_num, arg0, arg1, arg2, arg3, arg4, arg5);
     result
@@ -212,6 +220,93 @@ fn syscall_handler_inner(
                 }
             }
         }
+        SN_EXECV => {
+            let argv = arg0 as *const *const u8;
+            let flags = arg1 as i32;
+            let pipefd = arg2 as *const i32;
+
+            match sys_execv(argv, flags, pipefd) {
+                Ok(pid) => return pid as i64,
+                Err(err) => {
+                    kerror!("syscall: execv: {:?}", err);
+                    return -1;
+                }
+            }
+        }
+        SN_THREAD_CREATE => {
+            let entry = arg0;
+            let arg = arg1;
+
+            match sys_thread_create(entry, arg) {
+                Ok(tid) => return tid as i64,
+                Err(err) => {
+                    kerror!("syscall: thread_create: {:?}", err);
+                    return -1;
+                }
+            }
+        }
+        SN_THREAD_JOIN => {
+            let tid = arg0 as pid_t;
+
+            match sys_thread_join(tid) {
+                Ok(exit_code) => return exit_code as i64,
+                Err(err) => {
+                    kerror!("syscall: thread_join: {:?}", err);
+                    return -1;
+                }
+            }
+        }
+        SN_SHM_CREATE => {
+            let size = arg0 as usize;
+
+            match sys_shm_create(size) {
+                Ok(shm_id) => return shm_id as i64,
+                Err(err) => {
+                    kerror!("syscall: shm_create: {:?}", err);
+                    return -1;
+                }
+            }
+        }
+        SN_SHM_MAP => {
+            let shm_id = arg0 as u32;
+
+            match sys_shm_map(shm_id) {
+                Ok(virt_addr) => return virt_addr.get() as i64,
+                Err(err) => {
+                    kerror!("syscall: shm_map: {:?}", err);
+                    return 0;
+                }
+            }
+        }
+        SN_PROF_START => {
+            let pid = arg0 as pid_t;
+
+            if let Err(err) = sys_prof_start(pid) {
+                kerror!("syscall: prof_start: {:?}", err);
+                return -1;
+            }
+        }
+        SN_PROF_STOP => {
+            let buf = arg0 as *mut prof_sample;
+            let buf_len = arg1 as usize;
+
+            match sys_prof_stop(buf, buf_len) {
+                Ok(count) => return count as i64,
+                Err(err) => {
+                    kerror!("syscall: prof_stop: {:?}", err);
+                    return -1;
+                }
+            }
+        }
+        SN_TTYMODE => {
+            let mode = arg0 as i32;
+            let timeout_ms = arg1 as i32;
+
+            if let Err(err) = sys_ttymode(mode, timeout_ms) {
+                kerror!("syscall: ttymode: {:?}", err);
+                return -1;
+            }
+        }
         SN_GETCWD => {
             let buf = arg0 as *mut u8;
             let buf_len = arg1 as usize;
@@ -236,7 +331,8 @@ fn syscall_handler_inner(
         }
         SN_WAIT => {
             let pid = arg0 as pid_t;
-            match sys_wait(pid) {
+            let flags = arg1 as i32;
+            match sys_wait(pid, flags) {
                 Ok(exit_code) => return exit_code as i64,
                 Err(err) => {
                     kerror!("syscall: wait: {:?}", err);
@@ -326,6 +422,9 @@ fn syscall_handler_inner(
 
             match sys_recvfrom(sockfd, buf, len, flags, src_addr, addrlen) {
                 Ok(read_len) => return read_len as i64,
+                Err(err) if matches!(err.kind(), Error::BufferEmpty) => {
+                    return -(EAGAIN as i64);
+                }
                 Err(err) => {
                     kerror!("syscall: recvfrom: {:?}", err);
                     return -1;
@@ -354,6 +453,9 @@ fn syscall_handler_inner(
 
             match sys_recvfrom(sockfd, buf, len, flags, core::ptr::null(), 0) {
                 Ok(read_len) => return read_len as i64,
+                Err(err) if matches!(err.kind(), Error::BufferEmpty) => {
+                    return -(EAGAIN as i64);
+                }
                 Err(err) => {
                     kerror!("syscall: recv: {:?}", err);
                     return -1;
@@ -386,6 +488,9 @@ fn syscall_handler_inner(
 
             match sys_accept(sockfd, addr, addrlen) {
                 Ok(socket_id) => return socket_id.get() as i64,
+                Err(err) if matches!(err.kind(), Error::BufferEmpty) => {
+                    return -(EAGAIN as i64);
+                }
                 Err(err) => {
                     kerror!("syscall: accept: {:?}", err);
                     return -1;
@@ -400,6 +505,173 @@ fn syscall_handler_inner(
                 return -1;
             }
         }
+        SN_READV => {
+            let fd_num = arg0 as i32;
+            let iov = arg1 as *const iovec;
+            let iovcnt = arg2 as i32;
+            match sys_readv(fd_num, iov, iovcnt) {
+                Ok(len) => return len as i64,
+                Err(err) => {
+                    kerror!("syscall: readv: {:?}", err);
+                    return -1;
+                }
+            }
+        }
+        SN_WRITEV => {
+            let fd_num = arg0 as i32;
+            let iov = arg1 as *const iovec;
+            let iovcnt = arg2 as i32;
+            match sys_writev(fd_num, iov, iovcnt) {
+                Ok(len) => return len as i64,
+                Err(err) => {
+                    kerror!("syscall: writev: {:?}", err);
+                    return -1;
+                }
+            }
+        }
+        SN_MMAP => {
+            let fd_num = arg0 as i32;
+            let offset = arg1 as i64;
+            let len = arg2 as usize;
+            let prot = arg3 as i32;
+            match sys_mmap(fd_num, offset, len, prot) {
+                Ok(ptr) => return ptr as i64,
+                Err(err) => {
+                    kerror!("syscall: mmap: {:?}", err);
+                    return -1;
+                }
+            }
+        }
+        SN_TIMEPAGE => {
+            match sys_timepage() {
+                Ok(virt_addr) => return virt_addr.get() as i64,
+                Err(err) => {
+                    kerror!("syscall: timepage: {:?}", err);
+                    return -1;
+                }
+            }
+        }
+        SN_GETDENTS => {
+            let path = arg0 as *const u8;
+            let cursor = arg1 as *mut u64;
+            let buf = arg2 as *mut dirent;
+            let buf_len = arg3 as usize;
+            match sys_getdents(path, cursor, buf, buf_len) {
+                Ok(count) => return count as i64,
+                Err(err) => {
+                    kerror!("syscall: getdents: {:?}", err);
+                    return -1;
+                }
+            }
+        }
+        SN_COPYFD => {
+            let out_fd_num = arg0 as i32;
+            let in_fd_num = arg1 as i32;
+            let len = arg2 as usize;
+            match sys_copyfd(out_fd_num, in_fd_num, len) {
+                Ok(copied) => return copied as i64,
+                Err(err) => {
+                    kerror!("syscall: copyfd: {:?}", err);
+                    return -1;
+                }
+            }
+        }
+        SN_POLL => {
+            let fds = arg0 as *mut pollfd;
+            let nfds = arg1 as usize;
+            let timeout_ms = arg2 as i32;
+            match sys_poll(fds, nfds, timeout_ms) {
+                Ok(ready) => return ready as i64,
+                Err(err) => {
+                    kerror!("syscall: poll: {:?}", err);
+                    return -1;
+                }
+            }
+        }
+        SN_SENDMSG => {
+            let sockfd = arg0 as i32;
+            let msg = arg1 as *const msghdr;
+            let flags = arg2 as i32;
+            match sys_sendmsg(sockfd, msg, flags) {
+                Ok(send_len) => return send_len as i64,
+                Err(err) => {
+                    kerror!("syscall: sendmsg: {:?}", err);
+                    return -1;
+                }
+            }
+        }
+        SN_SETSOCKOPT => {
+            let sockfd = arg0 as i32;
+            let level = arg1 as i32;
+            let optname = arg2 as i32;
+            let optval = arg3 as *const u8;
+            let optlen = arg4 as usize;
+            if let Err(err) = sys_setsockopt(sockfd, level, optname, optval, optlen) {
+                kerror!("syscall: setsockopt: {:?}", err);
+                return -1;
+            }
+        }
+        SN_GETSOCKOPT => {
+            let sockfd = arg0 as i32;
+            let level = arg1 as i32;
+            let optname = arg2 as i32;
+            let optval = arg3 as *mut u8;
+            let optlen = arg4 as *mut usize;
+            if let Err(err) = sys_getsockopt(sockfd, level, optname, optval, optlen) {
+                kerror!("syscall: getsockopt: {:?}", err);
+                return -1;
+            }
+        }
+        SN_RECVRING => {
+            let sockfd = arg0 as i32;
+            let slot_size = arg1 as u32;
+            let slot_count = arg2 as u32;
+            match sys_recvring(sockfd, slot_size, slot_count) {
+                Ok(virt_addr) => return virt_addr.get() as i64,
+                Err(err) => {
+                    kerror!("syscall: recvring: {:?}", err);
+                    return -1;
+                }
+            }
+        }
+        SN_PREAD => {
+            let fd_num = arg0 as i32;
+            let buf = arg1 as *mut u8;
+            let buf_len = arg2 as usize;
+            let offset = arg3 as i64;
+            match sys_pread(fd_num, buf, buf_len, offset) {
+                Ok(read_len) => return read_len as i64,
+                Err(err) => {
+                    kerror!("syscall: pread: {:?}", err);
+                    return -1;
+                }
+            }
+        }
+        SN_PWRITE => {
+            let fd_num = arg0 as i32;
+            let buf = arg1 as *const u8;
+            let buf_len = arg2 as usize;
+            let offset = arg3 as i64;
+            match sys_pwrite(fd_num, buf, buf_len, offset) {
+                Ok(written_len) => return written_len as i64,
+                Err(err) => {
+                    kerror!("syscall: pwrite: {:?}", err);
+                    return -1;
+                }
+            }
+        }
+        SN_OPENSTAT => {
+            let filepath = arg0 as *const u8;
+            let flags = arg1 as i32;
+            let buf = arg2 as *mut f_stat;
+            match sys_openstat(filepath, flags, buf) {
+                Ok(fd) => return fd as i64,
+                Err(err) => {
+                    kerror!("syscall: openstat: {:?}", err);
+                    return -1;
+                }
+            }
+        }
         SN_LSEEK => {
             let fd_num = arg0 as i32;
             let offset = arg1 as i64;
@@ -450,6 +722,37 @@ fn sys_read(fd_num: i32, buf: *mut u8, buf_len: usize) -> Result<usize> {
                 }
             }
 
+            // raw mode drains every buffered byte in one call - a paste or
+            // a held key costs one syscall instead of one per byte
+            if let Some(timeout_ms) = x86_64::disabled_int(|| tty::raw_read_config())? {
+                let start_ms = util::time::global_uptime().as_millis() as i64;
+
+                loop {
+                    tty::check_sigint();
+
+                    let data = x86_64::disabled_int(|| tty::read_input_bytes(buf_len))?;
+                    if !data.is_empty() {
+                        unsafe {
+                            buf.copy_from_nonoverlapping(data.as_ptr(), data.len());
+                        }
+                        return Ok(data.len());
+                    }
+
+                    if timeout_ms == 0 {
+                        return Ok(0);
+                    }
+                    if timeout_ms > 0 {
+                        let now_ms = util::time::global_uptime().as_millis() as i64;
+                        if now_ms - start_ms >= timeout_ms as i64 {
+                            return Ok(0);
+                        }
+                    }
+
+                    task::scheduler::sched();
+                    x86_64::stihlt();
+                }
+            }
+
             if buf_len > 1 {
                 let mut input_s = None;
 
@@ -504,6 +807,27 @@ fn sys_read(fd_num: i32, buf: *mut u8, buf_len: usize) -> Result<usize> {
             }
         }
         fd => {
+            // input event queue fds block until a burst of records arrives,
+            // so subscribers sleep instead of spinning on sys_read
+            if device::input_event::is_event_fd(fd) {
+                loop {
+                    tty::check_sigint();
+                    match vfs::read_file(fd, buf_len) {
+                        Ok(data) => {
+                            unsafe {
+                                buf.copy_from_nonoverlapping(data.as_ptr(), data.len());
+                            }
+                            return Ok(data.len());
+                        }
+                        Err(err) if matches!(err.kind(), Error::BufferEmpty) => {
+                            task::scheduler::sched();
+                            x86_64::stihlt();
+                        }
+                        Err(err) => return Err(err),
+                    }
+                }
+            }
+
             let data = match vfs::read_file(fd, buf_len) {
                 Ok(data) => data,
                 // reading a raw pipe fd stays non-blocking: empty means "no data yet"
@@ -545,6 +869,224 @@ fn sys_write(fd_num: i32, buf: *const u8, buf_len: usize) -> Result<usize> {
     }
 }
 
+fn sys_copyfd(out_fd_num: i32, in_fd_num: i32, len: usize) -> Result<usize> {
+    // per-iteration copy size: bounds kernel memory while staying large
+    // enough to amortize the VFS walk
+    const CHUNK_LEN: usize = 65536;
+
+    let out_fd_num = FileDescriptorNumber::try_new(out_fd_num)?;
+    let in_fd_num = FileDescriptorNumber::try_new(in_fd_num)?;
+
+    match in_fd_num {
+        FileDescriptorNumber::STDIN
+        | FileDescriptorNumber::STDOUT
+        | FileDescriptorNumber::STDERR => {
+            return Err(Error::InvalidData.with_context("copy source"));
+        }
+        _ => (),
+    }
+
+    let mut copied = 0;
+    while copied < len {
+        let chunk_len = (len - copied).min(CHUNK_LEN);
+        let data = match vfs::read_file(in_fd_num, chunk_len) {
+            Ok(data) => data,
+            // a drained pipe source counts as end of data
+            Err(err) if matches!(err.kind(), Error::BufferEmpty) => break,
+            Err(err) => return Err(err),
+        };
+
+        if data.is_empty() {
+            break;
+        }
+
+        match out_fd_num {
+            FileDescriptorNumber::STDOUT | FileDescriptorNumber::STDERR => {
+                if let Some(fd_num) = task::scheduler::current_pipe_fd().and_then(|fds| fds[1]) {
+                    vfs::write_file(fd_num, &data)?;
+                } else {
+                    let s = String::from_utf8_lossy(&data).to_string();
+                    print!("{}", s);
+                }
+            }
+            FileDescriptorNumber::STDIN => {
+                return Err(Error::InvalidData.with_context("stdin write"));
+            }
+            fd => vfs::write_file(fd, &data)?,
+        }
+
+        copied += data.len();
+    }
+
+    Ok(copied)
+}
+
+// read-readiness of a single poll target - stdin resolves through the
+// task pipe or the tty input buffer, everything else through the VFS
+// with sockets as the fallback, like sys_close
+fn poll_fd_readable(fd: i32) -> Result<bool> {
+    let fd_num = FileDescriptorNumber::try_new(fd)?;
+
+    match fd_num {
+        FileDescriptorNumber::STDIN => {
+            if let Some(fd_num) = task::scheduler::current_pipe_fd().and_then(|fds| fds[0]) {
+                return vfs::is_fd_readable(fd_num);
+            }
+            Ok(tty::input_count()? > 0)
+        }
+        FileDescriptorNumber::STDOUT | FileDescriptorNumber::STDERR => {
+            Err(Error::InvalidData.with_context("poll fd"))
+        }
+        fd_num => {
+            if let Ok(readable) = vfs::is_fd_readable(fd_num) {
+                return Ok(readable);
+            }
+            net::is_socket_readable(SocketId::try_new(fd)?)
+        }
+    }
+}
+
+fn sys_poll(fds: *mut pollfd, nfds: usize, timeout_ms: i32) -> Result<usize> {
+    if fds.is_null() {
+        return Err(Error::InvalidData.with_context("poll fds"));
+    }
+    let fds = unsafe { slice::from_raw_parts_mut(fds, nfds) };
+    let start_ms = util::time::global_uptime().as_millis() as i64;
+
+    loop {
+        tty::check_sigint();
+
+        let mut ready = 0;
+        for f in fds.iter_mut() {
+            f.revents = 0;
+            if f.fd < 0 {
+                continue;
+            }
+
+            if f.events as u32 & POLLIN != 0 {
+                match poll_fd_readable(f.fd) {
+                    Ok(true) => f.revents |= POLLIN as i16,
+                    Ok(false) => (),
+                    Err(_) => f.revents |= POLLNVAL as i16,
+                }
+            }
+
+            // writes never sleep on this kernel (pipe buffers are
+            // unbounded), so any valid target is immediately writable
+            if f.events as u32 & POLLOUT != 0 && f.revents as u32 & POLLNVAL == 0 {
+                f.revents |= POLLOUT as i16;
+            }
+
+            if f.revents != 0 {
+                ready += 1;
+            }
+        }
+
+        if ready > 0 {
+            return Ok(ready);
+        }
+
+        if timeout_ms == 0 {
+            return Ok(0);
+        }
+        if timeout_ms > 0 {
+            let now_ms = util::time::global_uptime().as_millis() as i64;
+            if now_ms - start_ms >= timeout_ms as i64 {
+                return Ok(0);
+            }
+        }
+
+        task::scheduler::sched();
+        x86_64::stihlt();
+    }
+}
+
+// positional read: explicit offset, the shared fd position stays put so
+// tasks sharing an fd don't race on it
+fn sys_pread(fd_num: i32, buf: *mut u8, buf_len: usize, offset: i64) -> Result<usize> {
+    if buf.is_null() || offset < 0 {
+        return Err(Error::InvalidData.with_context("pread"));
+    }
+
+    let fd_num = FileDescriptorNumber::try_new(fd_num)?;
+    if matches!(
+        fd_num,
+        FileDescriptorNumber::STDIN | FileDescriptorNumber::STDOUT | FileDescriptorNumber::STDERR
+    ) {
+        return Err(Error::NotFound.with_context("file descriptor"));
+    }
+
+    let data = vfs::read_file_at(fd_num, offset as usize, buf_len)?;
+    unsafe {
+        buf.copy_from_nonoverlapping(data.as_ptr(), data.len());
+    }
+
+    Ok(data.len())
+}
+
+fn sys_pwrite(fd_num: i32, buf: *const u8, buf_len: usize, offset: i64) -> Result<usize> {
+    if buf.is_null() || offset < 0 {
+        return Err(Error::InvalidData.with_context("pwrite"));
+    }
+
+    let fd_num = FileDescriptorNumber::try_new(fd_num)?;
+    if matches!(
+        fd_num,
+        FileDescriptorNumber::STDIN | FileDescriptorNumber::STDOUT | FileDescriptorNumber::STDERR
+    ) {
+        return Err(Error::NotFound.with_context("file descriptor"));
+    }
+
+    let data = unsafe { slice::from_raw_parts(buf, buf_len) };
+    vfs::write_file_at(fd_num, offset as usize, data)?;
+
+    Ok(buf_len)
+}
+
+fn sys_readv(fd_num: i32, iov: *const iovec, iovcnt: i32) -> Result<usize> {
+    if iov.is_null() || iovcnt < 0 {
+        return Err(Error::InvalidData.with_context("iovec"));
+    }
+
+    let iovs = unsafe { slice::from_raw_parts(iov, iovcnt as usize) };
+    let mut total = 0;
+
+    for e in iovs {
+        if e.iov_len == 0 {
+            continue;
+        }
+
+        let len = sys_read(fd_num, e.iov_base as *mut u8, e.iov_len as usize)?;
+        total += len;
+
+        // short read: the remaining segments would block or hit EOF
+        if len < e.iov_len as usize {
+            break;
+        }
+    }
+
+    Ok(total)
+}
+
+fn sys_writev(fd_num: i32, iov: *const iovec, iovcnt: i32) -> Result<usize> {
+    if iov.is_null() || iovcnt < 0 {
+        return Err(Error::InvalidData.with_context("iovec"));
+    }
+
+    let iovs = unsafe { slice::from_raw_parts(iov, iovcnt as usize) };
+    let mut total = 0;
+
+    for e in iovs {
+        if e.iov_len == 0 {
+            continue;
+        }
+
+        total += sys_write(fd_num, e.iov_base as *const u8, e.iov_len as usize)?;
+    }
+
+    Ok(total)
+}
+
 fn sys_open(filepath: *const u8, flags: i32) -> Result<i32> {
     let filepath = unsafe { util::cstring::from_cstring_ptr(filepath) }
         .as_str()
@@ -590,6 +1132,41 @@ fn sys_sbrk(len: usize) -> Result<*const u8> {
     Ok(virt_addr.as_ptr())
 }
 
+// maps `len` bytes of the file into fresh user pages with one kernel-side
+// read, so the app avoids pulling large assets through a sys_read loop
+// (the backing store is not page-addressable, so a copy-on-map is the
+// closest this VFS gets to a real file mapping)
+fn sys_mmap(fd_num: i32, offset: i64, len: usize, _prot: i32) -> Result<*const u8> {
+    let fd_num = FileDescriptorNumber::try_new(fd_num)?;
+
+    if len == 0 {
+        return Err(Error::InvalidData.with_context("mmap length"));
+    }
+
+    let mem_frame = bitmap::alloc_mem_frame(len.div_ceil(PAGE_SIZE))?;
+    task::scheduler::current_map_user_page(&mem_frame)?;
+    let virt_addr = mem_frame.frame_start_virt_addr();
+
+    vfs::seek(fd_num, SeekFrom::Start(offset))?;
+    let data = vfs::read_file(fd_num, len)?;
+
+    unsafe {
+        let ptr = virt_addr.as_ptr_mut::<u8>();
+        ptr.write_bytes(0, len);
+        ptr.copy_from_nonoverlapping(data.as_ptr(), data.len());
+    }
+
+    task::scheduler::current_add_mem_frame(mem_frame)?;
+
+    Ok(virt_addr.as_ptr())
+}
+
+// hands the task a read-only view of the kernel time page so time()
+// and clock() become plain memory reads with TSC interpolation
+fn sys_timepage() -> Result<VirtualAddress> {
+    local_apic_timer::map_time_page_to_current_task()
+}
+
 fn sys_uname(buf: *mut utsname) -> Result<()> {
     let sysname = env::OS_NAME.as_bytes();
     let nodename = "nodename".as_bytes();
@@ -645,27 +1222,82 @@ fn sys_stat(fd_num: i32, buf: *mut f_stat) -> Result<()> {
     Ok(())
 }
 
+// combined open+stat: one path lookup instead of two syscalls, since
+// callers like fopen always need the size right after opening
+fn sys_openstat(filepath: *const u8, flags: i32, buf: *mut f_stat) -> Result<i32> {
+    if buf.is_null() {
+        return Err(Error::InvalidData.with_context("stat buffer"));
+    }
+
+    let fd_num = sys_open(filepath, flags)?;
+    if let Err(err) = sys_stat(fd_num, buf) {
+        let _ = sys_close(fd_num);
+        return Err(err);
+    }
+
+    Ok(fd_num)
+}
+
 fn sys_uptime() -> i64 {
     util::time::global_uptime().as_millis() as i64
 }
 
+fn exec_pipe_fd(pipefd: *const i32) -> [Option<FileDescriptorNumber>; 3] {
+    if pipefd.is_null() {
+        return [None, None, None];
+    }
+
+    let fds = unsafe { core::slice::from_raw_parts(pipefd, 3) };
+    [
+        FileDescriptorNumber::try_new(fds[0]).ok(),
+        FileDescriptorNumber::try_new(fds[1]).ok(),
+        FileDescriptorNumber::try_new(fds[2]).ok(),
+    ]
+}
+
 fn sys_exec(args: *const u8, flags: i32, pipefd: *const i32) -> Result<pid_t> {
     let args = unsafe { util::cstring::from_cstring_ptr(args) };
     let args: Vec<&str> = args.split(' ').collect();
 
-    let pipe_fd = if pipefd.is_null() {
-        [None, None, None]
-    } else {
-        let fds = unsafe { core::slice::from_raw_parts(pipefd, 3) };
-        [
-            FileDescriptorNumber::try_new(fds[0]).ok(),
-            FileDescriptorNumber::try_new(fds[1]).ok(),
-            FileDescriptorNumber::try_new(fds[2]).ok(),
-        ]
-    };
+    let enable_debug = (flags as u32) & EXEC_FLAG_DEBUG != 0;
+    let child_id = task::exec::exec_elf(
+        &args[0].into(),
+        &args[1..],
+        enable_debug,
+        exec_pipe_fd(pipefd),
+    )?;
+
+    Ok(child_id.0 as pid_t)
+}
+
+// argv-array variant of exec: arguments arrive already split, so shells
+// don't have to flatten them into one string the kernel re-parses (and
+// arguments may contain spaces)
+fn sys_execv(argv: *const *const u8, flags: i32, pipefd: *const i32) -> Result<pid_t> {
+    if argv.is_null() {
+        return Err(Error::InvalidData.with_context("argv"));
+    }
+
+    let mut args = Vec::new();
+    unsafe {
+        let mut ptr = argv;
+        while !(*ptr).is_null() {
+            args.push(util::cstring::from_cstring_ptr(*ptr));
+            ptr = ptr.add(1);
+        }
+    }
+    if args.is_empty() {
+        return Err(Error::InvalidData.with_context("argv"));
+    }
+    let args: Vec<&str> = args.iter().map(|s| s.as_str()).collect();
 
     let enable_debug = (flags as u32) & EXEC_FLAG_DEBUG != 0;
-    let child_id = task::exec::exec_elf(&args[0].into(), &args[1..], enable_debug, pipe_fd)?;
+    let child_id = task::exec::exec_elf(
+        &args[0].into(),
+        &args[1..],
+        enable_debug,
+        exec_pipe_fd(pipefd),
+    )?;
 
     Ok(child_id.0 as pid_t)
 }
@@ -707,8 +1339,38 @@ fn sys_free(ptr: *const u8) -> Result<()> {
     Ok(())
 }
 
-fn sys_wait(pid: pid_t) -> Result<i32> {
+fn sys_wait(pid: pid_t, flags: i32) -> Result<i32> {
     let task_id = TaskId::from(pid as usize);
+
+    // non-blocking probe for background jobs - the exit code stays
+    // queued until a blocking wait picks it up
+    if (flags as u32 & WAIT_FLAG_NOHANG) != 0 && !task::scheduler::has_exit_code(task_id) {
+        return Ok(WAIT_STILL_RUNNING);
+    }
+
+    task::scheduler::sleep_waiting_for(task_id);
+
+    let exit_code = task::scheduler::take_exit_code(task_id)
+        .ok_or(Error::NotFound.with_context("exit code"))?;
+
+    Ok(exit_code)
+}
+
+fn sys_thread_create(entry: u64, arg: u64) -> Result<pid_t> {
+    if entry == 0 {
+        return Err(Error::InvalidData.with_context("thread entry point"));
+    }
+
+    let task_id = task::scheduler::spawn_thread(entry, arg)?;
+
+    Ok(task_id.get() as pid_t)
+}
+
+// always blocking - a thread that is already gone still has its exit
+// code queued, so the join returns immediately in that case
+fn sys_thread_join(tid: pid_t) -> Result<i32> {
+    let task_id = TaskId::from(tid as usize);
+
     task::scheduler::sleep_waiting_for(task_id);
 
     let exit_code = task::scheduler::take_exit_code(task_id)
@@ -717,6 +1379,44 @@ fn sys_wait(pid: pid_t) -> Result<i32> {
     Ok(exit_code)
 }
 
+fn sys_prof_start(pid: pid_t) -> Result<()> {
+    debug::profiler::start(TaskId::from(pid as usize))
+}
+
+// hand out the collected histogram, truncated to buf_len entries
+fn sys_prof_stop(buf: *mut prof_sample, buf_len: usize) -> Result<usize> {
+    if buf.is_null() {
+        return Err(Error::InvalidData.with_context("buffer"));
+    }
+
+    let samples = debug::profiler::stop()?;
+    let count = samples.len().min(buf_len);
+    for (i, (addr, hit_count)) in samples.iter().take(count).enumerate() {
+        unsafe {
+            (*buf.add(i)).addr = *addr;
+            (*buf.add(i)).count = *hit_count;
+        }
+    }
+
+    Ok(count)
+}
+
+fn sys_ttymode(mode: i32, timeout_ms: i32) -> Result<()> {
+    match mode as u32 {
+        TTY_MODE_CANONICAL => tty::set_raw_mode(false, -1),
+        TTY_MODE_RAW => tty::set_raw_mode(true, timeout_ms),
+        _ => Err(Error::InvalidData.with_context("tty mode")),
+    }
+}
+
+fn sys_shm_create(size: usize) -> Result<u32> {
+    task::scheduler::current_create_shm(size)
+}
+
+fn sys_shm_map(shm_id: u32) -> Result<VirtualAddress> {
+    task::scheduler::current_map_shm(shm_id)
+}
+
 fn sys_sbrksz(target: *const u8) -> Result<usize> {
     let target_virt_addr: VirtualAddress = (target as u64).into();
     let size = task::scheduler::current_mem_frame_size(target_virt_addr)?;
@@ -759,13 +1459,126 @@ fn sys_getenames(path: *const u8, buf: *mut u8, buf_len: usize) -> Result<()> {
     Ok(())
 }
 
+// streams fixed-size directory records starting at *cursor and advances
+// it, so listing a large directory takes a few syscalls instead of one
+// open/stat/close round trip per entry
+fn sys_getdents(
+    path: *const u8,
+    cursor: *mut u64,
+    buf: *mut dirent,
+    buf_len: usize,
+) -> Result<usize> {
+    if cursor.is_null() || buf.is_null() {
+        return Err(Error::InvalidData.with_context("getdents"));
+    }
+
+    let path = unsafe { util::cstring::from_cstring_ptr(path) }
+        .as_str()
+        .into();
+
+    let max_records = buf_len / size_of::<dirent>();
+    if max_records == 0 {
+        return Err(Error::InvalidBufferSize {
+            required: size_of::<dirent>(),
+            actual: buf_len,
+        }
+        .into());
+    }
+
+    let entries = fs::vfs::dir_entries(&path)?;
+    let cursor_mut = unsafe { &mut *cursor };
+    let start = *cursor_mut as usize;
+
+    let mut count = 0;
+    for (name, metadata) in entries.iter().skip(start).take(max_records) {
+        let record = unsafe { &mut *buf.add(count) };
+        record.size = metadata.size as u64;
+        record.type_ = match metadata.file_type {
+            fs::vfs::FsFileType::Directory => DIRENT_TYPE_DIR as u8,
+            fs::vfs::FsFileType::File => DIRENT_TYPE_FILE as u8,
+        };
+
+        let name_bytes = name.as_bytes();
+        let copy_len = name_bytes.len().min(DIRENT_NAME_MAX as usize);
+        let name_i8: &[i8] =
+            unsafe { slice::from_raw_parts(name_bytes.as_ptr() as *const i8, copy_len) };
+        record.name.fill(0);
+        record.name[..copy_len].copy_from_slice(name_i8);
+
+        count += 1;
+    }
+
+    *cursor_mut += count as u64;
+    Ok(count)
+}
+
+const fn iomsg_align(len: usize) -> usize {
+    (len + 7) & !7
+}
+
+// a batch container executes its packed sub-commands in order and packs
+// the replies the same way, so multi-component setup and per-frame
+// multi-layer updates cost a single syscall
 fn sys_iomsg(msgbuf: *const u8, replymsgbuf: *mut u8, replymsgbuf_len: usize) -> Result<()> {
+    let header: &iomsg_header = unsafe { &*(msgbuf as *const iomsg_header) };
+
+    if header.cmd_id == IOMSG_CMD_BATCH {
+        let batch: &iomsg_batch = unsafe { &*(msgbuf as *const iomsg_batch) };
+        if replymsgbuf_len < size_of::<iomsg_batch>() {
+            return Err(Error::InvalidBufferSize {
+                required: size_of::<iomsg_batch>(),
+                actual: replymsgbuf_len,
+            }
+            .into());
+        }
+
+        let mut req_offset = size_of::<iomsg_batch>();
+        let mut reply_offset = size_of::<iomsg_batch>();
+        for _ in 0..batch.count {
+            let (req_len, reply_len) = iomsg_exec(
+                unsafe { msgbuf.add(req_offset) },
+                unsafe { replymsgbuf.add(reply_offset) },
+                replymsgbuf_len.saturating_sub(reply_offset),
+            )?;
+            req_offset += iomsg_align(req_len);
+            reply_offset += iomsg_align(reply_len);
+        }
+
+        let actual = req_offset - size_of::<iomsg_header>();
+        let required = header.payload_size as usize;
+        if required != actual {
+            return Err(Error::InvalidBufferSize { required, actual }.into());
+        }
+
+        unsafe {
+            let reply = replymsgbuf as *mut iomsg_batch;
+            (*reply).header = iomsg_header {
+                cmd_id: IOMSG_CMD_BATCH,
+                payload_size: (reply_offset - size_of::<iomsg_header>()) as u32,
+            };
+            (*reply).count = batch.count;
+        }
+
+        return Ok(());
+    }
+
+    iomsg_exec(msgbuf, replymsgbuf, replymsgbuf_len)?;
+    Ok(())
+}
+
+// executes one iomsg command and writes its reply, returning the
+// request and reply lengths in bytes (headers included)
+fn iomsg_exec(
+    msgbuf: *const u8,
+    replymsgbuf: *mut u8,
+    replymsgbuf_len: usize,
+) -> Result<(usize, usize)> {
     let mut offset = 0;
     let header: &iomsg_header = unsafe { &*(msgbuf as *const iomsg_header) };
     offset += size_of::<iomsg_header>();
     kdebug!("{:?}", header);
 
-    match header.cmd()? {
+    let reply_len = match header.cmd()? {
         IomsgCommand::RemoveComponent => {
             let layer_id: i32 = unsafe { *(msgbuf.offset(offset as isize) as *const i32) };
             offset += size_of::<i32>();
@@ -798,6 +1611,8 @@ fn sys_iomsg(msgbuf: *const u8, replymsgbuf: *mut u8, replymsgbuf_len: usize) ->
                 let reply_header_ptr = replymsgbuf as *mut iomsg_header;
                 reply_header_ptr.write(reply_header);
             }
+
+            size_of::<iomsg_header>()
         }
         IomsgCommand::CreateComponentWindow => {
             let x_pos: usize = unsafe { *(msgbuf.offset(offset as isize) as *const usize) };
@@ -842,6 +1657,8 @@ fn sys_iomsg(msgbuf: *const u8, replymsgbuf: *mut u8, replymsgbuf_len: usize) ->
                 (replymsgbuf.offset(size_of::<iomsg_header>() as isize) as *mut u64)
                     .write(reply_wd);
             }
+
+            size_of::<iomsg_header>() + size_of::<u64>()
         }
         IomsgCommand::CreateComponentImage => {
             let layer_id: i32 = unsafe { *(msgbuf.offset(offset as isize) as *const i32) };
@@ -899,10 +1716,135 @@ fn sys_iomsg(msgbuf: *const u8, replymsgbuf: *mut u8, replymsgbuf_len: usize) ->
                 (replymsgbuf.offset(size_of::<iomsg_header>() as isize) as *mut i32)
                     .write(new_layer_id.get() as i32);
             }
+
+            size_of::<iomsg_header>() + size_of::<i32>()
         }
-    }
+        IomsgCommand::FlushComponentImage => {
+            let layer_id: i32 = unsafe { *(msgbuf.offset(offset as isize) as *const i32) };
+            offset += size_of::<i32>();
+            offset += 4; // padding
+            let x: usize = unsafe { *(msgbuf.offset(offset as isize) as *const usize) };
+            offset += size_of::<usize>();
+            let y: usize = unsafe { *(msgbuf.offset(offset as isize) as *const usize) };
+            offset += size_of::<usize>();
+            let width: usize = unsafe { *(msgbuf.offset(offset as isize) as *const usize) };
+            offset += size_of::<usize>();
+            let height: usize = unsafe { *(msgbuf.offset(offset as isize) as *const usize) };
+            offset += size_of::<usize>();
 
-    Ok(())
+            let actual = offset - size_of::<iomsg_header>();
+            let required = header.payload_size as usize;
+            if actual != required {
+                return Err(Error::InvalidBufferSize { required, actual }.into());
+            }
+
+            if layer_id < 0 {
+                return Err(Error::InvalidData.with_context("layer ID"));
+            }
+
+            let layer_id = LayerId::from(layer_id as usize);
+            window_manager::flush_component_image(layer_id, Rect::new(x, y, width, height))?;
+
+            // reply
+            let reply_header = iomsg_header::new(IomsgCommand::FlushComponentImage, 0);
+            if replymsgbuf_len < size_of::<iomsg_header>() {
+                return Err(Error::InvalidBufferSize {
+                    required: size_of::<iomsg_header>(),
+                    actual: replymsgbuf_len,
+                }
+                .into());
+            }
+
+            unsafe {
+                let reply_header_ptr = replymsgbuf as *mut iomsg_header;
+                reply_header_ptr.write(reply_header);
+            }
+
+            size_of::<iomsg_header>()
+        }
+        IomsgCommand::FlipComponentImage => {
+            let layer_id: i32 = unsafe { *(msgbuf.offset(offset as isize) as *const i32) };
+            offset += size_of::<i32>();
+            offset += 4; // padding
+            let framebuf_ptr =
+                unsafe { *(msgbuf.offset(offset as isize) as *const usize) } as *const u8;
+            offset += size_of::<usize>();
+
+            let actual = offset - size_of::<iomsg_header>();
+            let required = header.payload_size as usize;
+            if actual != required {
+                return Err(Error::InvalidBufferSize { required, actual }.into());
+            }
+
+            if layer_id < 0 {
+                return Err(Error::InvalidData.with_context("layer ID"));
+            }
+
+            if framebuf_ptr.is_null() {
+                return Err(Error::InvalidData.with_context("framebuf"));
+            }
+
+            let layer_id = LayerId::from(layer_id as usize);
+            let framebuf_virt_addr: VirtualAddress = (framebuf_ptr as u64).into();
+            window_manager::flip_component_image(layer_id, framebuf_virt_addr)?;
+
+            // reply
+            let reply_header = iomsg_header::new(IomsgCommand::FlipComponentImage, 0);
+            if replymsgbuf_len < size_of::<iomsg_header>() {
+                return Err(Error::InvalidBufferSize {
+                    required: size_of::<iomsg_header>(),
+                    actual: replymsgbuf_len,
+                }
+                .into());
+            }
+
+            unsafe {
+                let reply_header_ptr = replymsgbuf as *mut iomsg_header;
+                reply_header_ptr.write(reply_header);
+            }
+
+            size_of::<iomsg_header>()
+        }
+        IomsgCommand::SubscribeInput => {
+            let layer_id: i32 = unsafe { *(msgbuf.offset(offset as isize) as *const i32) };
+            offset += size_of::<i32>();
+
+            let actual = offset - size_of::<iomsg_header>();
+            let required = header.payload_size as usize;
+            if actual != required {
+                return Err(Error::InvalidBufferSize { required, actual }.into());
+            }
+
+            if layer_id < 0 {
+                return Err(Error::InvalidData.with_context("layer ID"));
+            }
+
+            let event_fd = input_event::subscribe()?;
+            task::scheduler::current_add_fd(event_fd)?;
+
+            // reply
+            let reply_header =
+                iomsg_header::new(IomsgCommand::SubscribeInput, size_of::<i32>() as u32);
+            if replymsgbuf_len < size_of::<iomsg_header>() + size_of::<i32>() {
+                return Err(Error::InvalidBufferSize {
+                    required: size_of::<iomsg_header>() + size_of::<i32>(),
+                    actual: replymsgbuf_len,
+                }
+                .into());
+            }
+
+            unsafe {
+                let reply_header_ptr = replymsgbuf as *mut iomsg_header;
+                reply_header_ptr.write(reply_header);
+                (replymsgbuf.offset(size_of::<iomsg_header>() as isize) as *mut i32)
+                    .write(event_fd.get() as i32);
+            }
+
+            size_of::<iomsg_header>() + size_of::<i32>()
+        }
+    };
+
+    Ok((offset, reply_len))
 }
 
 fn sys_socket(domain: i32, type_: i32, _protocol: i32) -> Result<SocketId> {
@@ -910,13 +1852,18 @@ fn sys_socket(domain: i32, type_: i32, _protocol: i32) -> Result<SocketId> {
         return Err(Error::InvalidData.with_context("socket domain"));
     }
 
-    let socket_type = match type_ as u32 {
+    let socket_type = match type_ as u32 & !SOCKET_TYPE_NONBLOCK {
         SOCKET_TYPE_SOCK_STREAM => SocketType::Stream,
         SOCKET_TYPE_SOCK_DGRAM => SocketType::Dgram,
         _ => return Err(Error::InvalidData.with_context("socket type")),
     };
 
-    net::create_new_socket(socket_type)
+    let socket_id = net::create_new_socket(socket_type)?;
+    if type_ as u32 & SOCKET_TYPE_NONBLOCK != 0 {
+        net::set_socket_nonblock(socket_id, true)?;
+    }
+
+    Ok(socket_id)
 }
 
 fn sys_bind(sockfd: i32, addr: *const sockaddr, addrlen: usize) -> Result<()> {
@@ -957,14 +1904,18 @@ fn sys_sendto(
     addrlen: usize,
 ) -> Result<usize> {
     let socket_id = SocketId::try_new(sockfd)?;
-    let data = unsafe { slice::from_raw_parts(buf, len) };
 
     if dest_addr.is_null() {
-        // TCP
+        // TCP - a single send accepts at most SO_SNDBUF bytes; callers
+        // see the short count and loop
+        let send_len = len.min(net::socket_snd_buf_size(socket_id)?);
+        let data = unsafe { slice::from_raw_parts(buf, send_len) };
         net::send_tcp_packet(socket_id, data)?;
-        return Ok(data.len());
+        return Ok(send_len);
     }
 
+    let data = unsafe { slice::from_raw_parts(buf, len) };
+
     // UDP
     let addr = unsafe { *(dest_addr as *const sockaddr_in) };
     assert_eq!(size_of::<sockaddr_in>(), addrlen);
@@ -976,6 +1927,148 @@ fn sys_sendto(
     Ok(data.len())
 }
 
+fn sys_sendmsg(sockfd: i32, msg: *const msghdr, _flags: i32) -> Result<usize> {
+    if msg.is_null() {
+        return Err(Error::InvalidData.with_context("msghdr"));
+    }
+
+    let msg = unsafe { &*msg };
+    if msg.msg_iov.is_null() {
+        return Err(Error::InvalidData.with_context("iovec"));
+    }
+
+    let socket_id = SocketId::try_new(sockfd)?;
+    let iovs = unsafe { slice::from_raw_parts(msg.msg_iov, msg.msg_iovlen as usize) };
+
+    // gather the segments once, into the buffer that becomes the packet
+    // payload - userspace never has to assemble a contiguous copy
+    let total: usize = iovs.iter().map(|e| e.iov_len as usize).sum();
+    let mut data = Vec::with_capacity(total);
+    for e in iovs {
+        if e.iov_len == 0 {
+            continue;
+        }
+
+        let seg = unsafe { slice::from_raw_parts(e.iov_base as *const u8, e.iov_len as usize) };
+        data.extend_from_slice(seg);
+    }
+
+    if msg.msg_name.is_null() {
+        // TCP - cap a single send at SO_SNDBUF, like sys_sendto
+        let send_len = total.min(net::socket_snd_buf_size(socket_id)?);
+        data.truncate(send_len);
+        net::send_tcp_data(socket_id, data)?;
+        return Ok(send_len);
+    }
+
+    // UDP
+    let addr = unsafe { *(msg.msg_name as *const sockaddr_in) };
+    assert_eq!(size_of::<sockaddr_in>(), msg.msg_namelen as usize);
+
+    let dst_addr = addr.sin_addr.s_addr.into();
+    let dst_port = addr.sin_port;
+
+    net::sendto_udp_v4(socket_id, dst_addr, dst_port, &data)?;
+    Ok(total)
+}
+
+fn sys_setsockopt(
+    sockfd: i32,
+    level: i32,
+    optname: i32,
+    optval: *const u8,
+    optlen: usize,
+) -> Result<()> {
+    if optval.is_null() {
+        return Err(Error::InvalidData.with_context("optval"));
+    }
+
+    // all supported options are int-valued
+    if optlen != size_of::<i32>() {
+        return Err(Error::InvalidBufferSize {
+            required: size_of::<i32>(),
+            actual: optlen,
+        }
+        .into());
+    }
+
+    let socket_id = SocketId::try_new(sockfd)?;
+    let value = unsafe { *(optval as *const i32) };
+
+    match (level as u32, optname as u32) {
+        (SOL_SOCKET, SO_RCVBUF) => {
+            if value <= 0 {
+                return Err(Error::InvalidData.with_context("SO_RCVBUF"));
+            }
+            net::set_socket_rcv_buf_size(socket_id, value as usize)
+        }
+        (SOL_SOCKET, SO_SNDBUF) => {
+            if value <= 0 {
+                return Err(Error::InvalidData.with_context("SO_SNDBUF"));
+            }
+            net::set_socket_snd_buf_size(socket_id, value as usize)
+        }
+        (IPPROTO_TCP, TCP_NODELAY) => net::set_tcp_nodelay(socket_id, value != 0),
+        _ => Err(Error::InvalidData.with_context("socket option")),
+    }
+}
+
+fn sys_getsockopt(
+    sockfd: i32,
+    level: i32,
+    optname: i32,
+    optval: *mut u8,
+    optlen: *mut usize,
+) -> Result<()> {
+    if optval.is_null() || optlen.is_null() {
+        return Err(Error::InvalidData.with_context("optval"));
+    }
+
+    let len = unsafe { *optlen };
+    if len < size_of::<i32>() {
+        return Err(Error::InvalidBufferSize {
+            required: size_of::<i32>(),
+            actual: len,
+        }
+        .into());
+    }
+
+    let socket_id = SocketId::try_new(sockfd)?;
+    let value = match (level as u32, optname as u32) {
+        (SOL_SOCKET, SO_RCVBUF) => net::socket_rcv_buf_size(socket_id)? as i32,
+        (SOL_SOCKET, SO_SNDBUF) => net::socket_snd_buf_size(socket_id)? as i32,
+        (IPPROTO_TCP, TCP_NODELAY) => net::tcp_nodelay(socket_id)? as i32,
+        (IPPROTO_TCP, TCP_WINDOW) => net::tcp_recv_window(socket_id)? as i32,
+        _ => return Err(Error::InvalidData.with_context("socket option")),
+    };
+
+    unsafe {
+        *(optval as *mut i32) = value;
+        *optlen = size_of::<i32>();
+    }
+
+    Ok(())
+}
+
+// maps a shared receive ring into the task and switches the socket to
+// ring delivery: payloads skip the socket queue and the sys_recv copy,
+// the app consumes filled slots directly
+fn sys_recvring(sockfd: i32, slot_size: u32, slot_count: u32) -> Result<VirtualAddress> {
+    let socket_id = SocketId::try_new(sockfd)?;
+
+    let (ring, mem_frame) = net::recv_ring::RecvRing::new(slot_size, slot_count)?;
+    task::scheduler::current_map_user_page(&mem_frame)?;
+    let virt_addr = mem_frame.frame_start_virt_addr();
+
+    // the frame is parked with the task's other user allocations so it
+    // lives as long as the mapping - closing the socket drops the ring
+    // but must not free memory the task can still touch
+    task::scheduler::current_add_mem_frame(mem_frame)?;
+    net::set_socket_recv_ring(socket_id, ring)?;
+
+    Ok(virt_addr)
+}
+
 fn sys_recvfrom(
     sockfd: i32,
     buf: *mut u8,
@@ -986,6 +2079,7 @@ fn sys_recvfrom(
 ) -> Result<usize> {
     let socket_id = SocketId::try_new(sockfd)?;
     let buf_mut = unsafe { slice::from_raw_parts_mut(buf, len) };
+    let nonblock = net::is_socket_nonblock(socket_id)?;
 
     if src_addr.is_null() {
         // TCP
@@ -993,6 +2087,9 @@ fn sys_recvfrom(
             match net::recv_tcp_packet(socket_id, buf_mut) {
                 Ok(0) => match net::is_tcp_established(socket_id) {
                     Ok(true) => {
+                        if nonblock {
+                            return Err(Error::BufferEmpty.into());
+                        }
                         x86_64::stihlt();
                         continue;
                     }
@@ -1009,6 +2106,9 @@ fn sys_recvfrom(
 
     // UDP
     let read_len = net::recvfrom_udp_v4(socket_id, buf_mut)?;
+    if nonblock && read_len == 0 {
+        return Err(Error::BufferEmpty.into());
+    }
     Ok(read_len)
 }
 
@@ -1043,6 +2143,14 @@ fn sys_listen(sockfd: i32, backlog: i32) -> Result<()> {
 fn sys_accept(sockfd: i32, addr: *const sockaddr, addrlen: *const i32) -> Result<SocketId> {
     let socket_id = SocketId::try_new(sockfd)?;
 
+    if net::is_socket_nonblock(socket_id)? {
+        return match net::accept_tcp_v4(socket_id) {
+            Ok(client_socket_id) => Ok(client_socket_id),
+            // no pending connection
+            Err(_) => Err(Error::BufferEmpty.into()),
+        };
+    }
+
     loop {
         tty::check_sigint();
         match net::accept_tcp_v4(socket_id) {
@@ -78,6 +78,11 @@ impl AnsiEscapeStream {
         self.buf.reset_ptr();
     }
 
+    // true while no escape sequence is being accumulated
+    pub fn is_idle(&self) -> bool {
+        matches!(self.state, State::Normal)
+    }
+
     fn parse_csi_seq(&mut self) -> Option<AnsiEvent> {
         let mut seq = String::new();
         while let Ok(ch) = self.buf.dequeue() {
@@ -0,0 +1,88 @@
+use alloc::{collections::btree_map::BTreeMap, collections::vec_deque::VecDeque, vec::Vec};
+
+// map with least-recently-used eviction: get() refreshes an entry, and
+// the caller evicts through pop_lru() until its size budget is met
+#[derive(Debug)]
+pub struct LruCache<K: Ord + Clone, V> {
+    entries: BTreeMap<K, V>,
+    // keys ordered from least to most recently used
+    order: VecDeque<K>,
+}
+
+impl<K: Ord + Clone, V> LruCache<K, V> {
+    pub const fn new() -> Self {
+        Self {
+            entries: BTreeMap::new(),
+            order: VecDeque::new(),
+        }
+    }
+
+    pub fn len(&self) -> usize {
+        self.entries.len()
+    }
+
+    pub fn get(&mut self, key: &K) -> Option<&V> {
+        if !self.entries.contains_key(key) {
+            return None;
+        }
+
+        self.touch(key);
+        self.entries.get(key)
+    }
+
+    pub fn insert(&mut self, key: K, value: V) {
+        if self.entries.insert(key.clone(), value).is_some() {
+            self.touch(&key);
+        } else {
+            self.order.push_back(key);
+        }
+    }
+
+    pub fn pop_lru(&mut self) -> Option<(K, V)> {
+        let key = self.order.pop_front()?;
+        let value = self.entries.remove(&key)?;
+        Some((key, value))
+    }
+
+    pub fn remove(&mut self, key: &K) -> Option<V> {
+        if let Some(index) = self.order.iter().position(|k| k == key) {
+            self.order.remove(index);
+        }
+        self.entries.remove(key)
+    }
+
+    pub fn clear(&mut self) {
+        self.entries.clear();
+        self.order.clear();
+    }
+
+    pub fn values(&self) -> impl Iterator<Item = &V> {
+        self.entries.values()
+    }
+
+    pub fn keys(&self) -> Vec<K> {
+        self.order.iter().cloned().collect()
+    }
+
+    fn touch(&mut self, key: &K) {
+        if let Some(index) = self.order.iter().position(|k| k == key) {
+            let key = self.order.remove(index).unwrap();
+            self.order.push_back(key);
+        }
+    }
+}
+
+#[test_case]
+fn test_lru_order() {
+    let mut cache = LruCache::new();
+    cache.insert(1, "a");
+    cache.insert(2, "b");
+    cache.insert(3, "c");
+
+    // refresh 1, so 2 becomes the eviction candidate
+    assert_eq!(cache.get(&1), Some(&"a"));
+    assert_eq!(cache.pop_lru(), Some((2, "b")));
+    assert_eq!(cache.pop_lru(), Some((3, "c")));
+    assert_eq!(cache.pop_lru(), Some((1, "a")));
+    assert_eq!(cache.pop_lru(), None);
+}
@@ -3,6 +3,7 @@ pub mod bits;
 pub mod cstring;
 pub mod fifo;
 pub mod keyboard;
+pub mod lru;
 pub mod mmio;
 pub mod random;
 pub mod range;